@@ -0,0 +1,125 @@
+#include <windows.h>
+#include <wrl.h>
+#include <d3d12.h>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+#include "ParallelRecorder.h"
+
+using Microsoft::WRL::ComPtr;
+
+// -----------------------------------------------------------
+// Recording benchmark
+//   Records 100k draws (root constant + DrawIndexedInstanced, the
+//   same commands the scene tasks emit) through ParallelRecorder on
+//   1 thread and on every hardware thread, and reports the CPU
+//   time per frame. Lists are closed but never executed: only the
+//   recording cost is measured, so no PSO or geometry is needed.
+// -----------------------------------------------------------
+namespace
+{
+    const UINT kDrawCount = 100000;
+    const UINT kWarmupFrames = 3;
+    const UINT kMeasuredFrames = 20;
+
+    bool CreateRootSignature(ID3D12Device* device, ComPtr<ID3D12RootSignature>& rootSignature)
+    {
+        D3D12_ROOT_PARAMETER param{};
+        param.ParameterType = D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS;
+        param.Constants.Num32BitValues = 1;
+        param.ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL;
+
+        D3D12_ROOT_SIGNATURE_DESC desc{};
+        desc.NumParameters = 1;
+        desc.pParameters = &param;
+        desc.Flags = D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT;
+
+        ComPtr<ID3DBlob> blob;
+        ComPtr<ID3DBlob> error;
+        if (FAILED(D3D12SerializeRootSignature(&desc, D3D_ROOT_SIGNATURE_VERSION_1, &blob, &error)))
+            return false;
+        return SUCCEEDED(device->CreateRootSignature(0, blob->GetBufferPointer(), blob->GetBufferSize(),
+            IID_PPV_ARGS(&rootSignature)));
+    }
+
+    // Average milliseconds to record one frame of kDrawCount draws
+    double Measure(ID3D12Device* device, ID3D12RootSignature* rootSignature, UINT threads)
+    {
+        ParallelRecorder recorder;
+        if (!recorder.Initialize(device, D3D12_COMMAND_LIST_TYPE_DIRECT, threads))
+            return -1.0;
+
+        const UINT taskCount = recorder.WorkerCount();
+        const UINT drawsPerTask = (kDrawCount + taskCount - 1) / taskCount;
+
+        const D3D12_VIEWPORT viewport{ 0.0f, 0.0f, 1280.0f, 720.0f, 0.0f, 1.0f };
+        const D3D12_RECT scissor{ 0, 0, 1280, 720 };
+        const D3D12_VERTEX_BUFFER_VIEW vbv{};
+        const D3D12_INDEX_BUFFER_VIEW ibv{ 0, 0, DXGI_FORMAT_R16_UINT };
+
+        ParallelRecorder::RecordTask task = [&](ID3D12GraphicsCommandList* list, UINT taskIndex)
+        {
+            list->SetGraphicsRootSignature(rootSignature);
+            list->RSSetViewports(1, &viewport);
+            list->RSSetScissorRects(1, &scissor);
+            list->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+            list->IASetVertexBuffers(0, 1, &vbv);
+            list->IASetIndexBuffer(&ibv);
+
+            const UINT first = taskIndex * drawsPerTask;
+            const UINT last = first + drawsPerTask < kDrawCount ? first + drawsPerTask : kDrawCount;
+            for (UINT i = first; i < last; ++i)
+            {
+                list->SetGraphicsRoot32BitConstant(0, i, 0);
+                list->DrawIndexedInstanced(3, 1, 0, 0, 0);
+            }
+        };
+
+        // Never executed, so every list can be recycled right away
+        std::vector<ID3D12CommandList*> lists;
+        double totalMs = 0.0;
+        for (UINT frame = 0; frame < kWarmupFrames + kMeasuredFrames; ++frame)
+        {
+            const auto start = std::chrono::steady_clock::now();
+            const bool ok = recorder.Record(taskCount, task, 0, nullptr, lists);
+            const auto end = std::chrono::steady_clock::now();
+            recorder.Retire(0);
+            if (!ok) return -1.0;
+
+            if (frame >= kWarmupFrames)
+                totalMs += std::chrono::duration<double, std::milli>(end - start).count();
+        }
+        return totalMs / kMeasuredFrames;
+    }
+}
+
+int main()
+{
+    ComPtr<ID3D12Device> device;
+    ComPtr<ID3D12RootSignature> rootSignature;
+    if (FAILED(D3D12CreateDevice(nullptr, D3D_FEATURE_LEVEL_11_0, IID_PPV_ARGS(&device))) ||
+        !CreateRootSignature(device.Get(), rootSignature))
+    {
+        std::printf("D3D12 device creation failed\n");
+        return 1;
+    }
+
+    UINT cores = std::thread::hardware_concurrency();
+    if (cores == 0) cores = 1;
+
+    const double single = Measure(device.Get(), rootSignature.Get(), 1);
+    const double parallel = Measure(device.Get(), rootSignature.Get(), cores);
+    if (single < 0.0 || parallel < 0.0)
+    {
+        std::printf("Recording failed\n");
+        return 1;
+    }
+
+    std::printf("%u draws per frame, %u frames\n", kDrawCount, kMeasuredFrames);
+    std::printf("  1 thread   : %8.3f ms/frame  %6.2f Mdraws/s\n", single, kDrawCount / single / 1000.0);
+    std::printf("  %2u threads : %8.3f ms/frame  %6.2f Mdraws/s\n", cores, parallel, kDrawCount / parallel / 1000.0);
+    std::printf("  speedup    : %.2fx\n", single / parallel);
+    return 0;
+}
@@ -0,0 +1,13 @@
+// Bindless resource table (root signature 1.1, shader model 5.1).
+// Every array starts at the same descriptor, so a handle indexes any of them.
+
+#define BINDLESS_INVALID 0xFFFFFFFF
+
+cbuffer DrawConstants : register(b0)
+{
+    uint g_resourceIndex;   // bindless handle for this draw
+};
+
+Texture2D g_textures[] : register(t0, space1);
+ByteAddressBuffer g_buffers[] : register(t0, space2);
+RWByteAddressBuffer g_rwBuffers[] : register(u0, space1);
@@ -0,0 +1,117 @@
+#include "BundleCache.h"
+
+bool BundleCache::Initialize(ID3D12Device* device)
+{
+    m_device = device;
+    return m_device != nullptr;
+}
+
+void BundleCache::Shutdown()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_entries.clear();
+    m_retired.clear();
+}
+
+ID3D12GraphicsCommandList* BundleCache::Get(UINT64 key, UINT64 signature, ID3D12PipelineState* initialState,
+    const RecordFn& record, UINT64 useFence)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        auto it = m_entries.find(key);
+        if (it != m_entries.end() && it->second.signature == signature)
+        {
+            it->second.lastUseFence = useFence;
+            return it->second.bundle.Get();
+        }
+    }
+
+    // Recorded without the lock so that other threads can look up or
+    // record their own bundles meanwhile. One allocator per bundle, since
+    // resetting it would invalidate every bundle recorded from it.
+    Entry entry;
+    if (FAILED(m_device->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_BUNDLE, IID_PPV_ARGS(&entry.allocator))))
+        return nullptr;
+    if (FAILED(m_device->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_BUNDLE, entry.allocator.Get(), initialState, IID_PPV_ARGS(&entry.bundle))))
+        return nullptr;
+
+    record(entry.bundle.Get());
+    if (FAILED(entry.bundle->Close()))
+        return nullptr;
+
+    entry.signature = signature;
+    entry.lastUseFence = useFence;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto it = m_entries.find(key);
+    if (it != m_entries.end())
+    {
+        // Another thread recorded the same inputs first; ours was never
+        // executed and can go right away
+        if (it->second.signature == signature)
+        {
+            it->second.lastUseFence = useFence;
+            return it->second.bundle.Get();
+        }
+
+        // Inputs changed: keep the old bundle alive until the GPU is done with it
+        RetireLocked(it->second);
+        m_entries.erase(it);
+    }
+
+    Entry& stored = m_entries[key];
+    stored = std::move(entry);
+    return stored.bundle.Get();
+}
+
+void BundleCache::Invalidate(UINT64 key)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto it = m_entries.find(key);
+    if (it == m_entries.end()) return;
+
+    RetireLocked(it->second);
+    m_entries.erase(it);
+}
+
+void BundleCache::InvalidateAll()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    for (auto& kv : m_entries)
+        RetireLocked(kv.second);
+    m_entries.clear();
+}
+
+void BundleCache::Collect(UINT64 completedFence)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    size_t kept = 0;
+    for (size_t i = 0; i < m_retired.size(); ++i)
+    {
+        if (m_retired[i].lastUseFence > completedFence)
+            m_retired[kept++] = std::move(m_retired[i]);
+    }
+    m_retired.resize(kept);
+}
+
+UINT64 BundleCache::Hash(const void* data, size_t size, UINT64 seed)
+{
+    const BYTE* bytes = static_cast<const BYTE*>(data);
+    UINT64 hash = seed;
+    for (size_t i = 0; i < size; ++i)
+    {
+        hash ^= bytes[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+void BundleCache::RetireLocked(Entry& entry)
+{
+    m_retired.push_back(std::move(entry));
+}
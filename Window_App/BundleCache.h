@@ -0,0 +1,69 @@
+#pragma once
+
+#include <windows.h>
+#include <wrl.h>
+#include <d3d12.h>
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+using Microsoft::WRL::ComPtr;
+
+// -----------------------------------------------------------
+// BundleCache
+//   Records static draw sequences once into bundles and replays
+//   them with ExecuteBundle. Each entry remembers a signature of
+//   the inputs it was recorded from (PSO, buffers, draw ranges...);
+//   it is re-recorded only when the caller passes a different one.
+//   Replaced bundles stay alive until their last use has retired.
+// -----------------------------------------------------------
+class BundleCache
+{
+public:
+    using RecordFn = std::function<void(ID3D12GraphicsCommandList* bundle)>;
+
+    bool Initialize(ID3D12Device* device);
+    void Shutdown();
+
+    /// Returns a closed bundle for key, recording it if missing or if
+    /// signature changed. useFence is the fence value of the submission
+    /// that will execute the bundle. Safe to call from several threads;
+    /// recording runs outside the lock.
+    ID3D12GraphicsCommandList* Get(UINT64 key, UINT64 signature, ID3D12PipelineState* initialState,
+        const RecordFn& record, UINT64 useFence);
+
+    /// Drops one entry / every entry (retired once useFence completes).
+    void Invalidate(UINT64 key);
+    void InvalidateAll();
+
+    /// Releases replaced bundles whose last use has completed.
+    void Collect(UINT64 completedFence);
+
+    /// FNV-1a, for building signatures out of plain structs.
+    static UINT64 Hash(const void* data, size_t size, UINT64 seed = 14695981039346656037ull);
+
+    template <typename T>
+    static UINT64 HashValue(const T& value, UINT64 seed = 14695981039346656037ull)
+    {
+        return Hash(&value, sizeof(T), seed);
+    }
+
+private:
+    struct Entry
+    {
+        ComPtr<ID3D12CommandAllocator> allocator;
+        ComPtr<ID3D12GraphicsCommandList> bundle;
+        UINT64 signature = 0;
+        UINT64 lastUseFence = 0;
+    };
+
+    void RetireLocked(Entry& entry);
+
+private:
+    ID3D12Device* m_device = nullptr;
+
+    std::mutex m_mutex;
+    std::unordered_map<UINT64, Entry> m_entries;
+    std::vector<Entry> m_retired;
+};
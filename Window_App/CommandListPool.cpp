@@ -0,0 +1,75 @@
+#include "CommandListPool.h"
+
+bool CommandListPool::Initialize(ID3D12Device* device, D3D12_COMMAND_LIST_TYPE type)
+{
+    m_device = device;
+    m_type = type;
+    return m_device != nullptr;
+}
+
+void CommandListPool::Shutdown()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_free.clear();
+    m_inFlight.clear();
+}
+
+ID3D12GraphicsCommandList* CommandListPool::Acquire(UINT64 completedFence, ID3D12PipelineState* initialState)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    // Reuse the first pair whose submission has retired
+    for (size_t i = 0; i < m_free.size(); ++i)
+    {
+        if (m_free[i].fenceValue > completedFence)
+            continue;
+
+        Entry entry = std::move(m_free[i]);
+        m_free.erase(m_free.begin() + i);
+
+        if (FAILED(entry.allocator->Reset()) ||
+            FAILED(entry.list->Reset(entry.allocator.Get(), initialState)))
+            return nullptr;
+
+        m_inFlight.push_back(std::move(entry));
+        return m_inFlight.back().list.Get();
+    }
+
+    // Nothing retired yet: grow the pool
+    Entry entry;
+    if (FAILED(m_device->CreateCommandAllocator(m_type, IID_PPV_ARGS(&entry.allocator))))
+        return nullptr;
+    if (FAILED(m_device->CreateCommandList(0, m_type, entry.allocator.Get(), initialState, IID_PPV_ARGS(&entry.list))))
+        return nullptr;
+
+    m_inFlight.push_back(std::move(entry));
+    return m_inFlight.back().list.Get();
+}
+
+void CommandListPool::Release(ID3D12GraphicsCommandList* list, UINT64 fenceValue)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    for (size_t i = 0; i < m_inFlight.size(); ++i)
+    {
+        if (m_inFlight[i].list.Get() != list)
+            continue;
+
+        m_inFlight[i].fenceValue = fenceValue;
+        m_free.push_back(std::move(m_inFlight[i]));
+        m_inFlight.erase(m_inFlight.begin() + i);
+        return;
+    }
+}
+
+void CommandListPool::ReleaseAll(UINT64 fenceValue)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    for (Entry& entry : m_inFlight)
+    {
+        entry.fenceValue = fenceValue;
+        m_free.push_back(std::move(entry));
+    }
+    m_inFlight.clear();
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <windows.h>
+#include <wrl.h>
+#include <d3d12.h>
+#include <mutex>
+#include <vector>
+
+using Microsoft::WRL::ComPtr;
+
+// -----------------------------------------------------------
+// CommandListPool
+//   Hands out allocator/list pairs on demand. A pair is returned
+//   together with the fence value of the submission that used it,
+//   and is handed out again only after that value has completed,
+//   so callers never have to reason about allocator lifetimes.
+//
+//   Acquire / Release are internally locked; for hot paths give
+//   every recording thread its own pool so the lock is uncontended.
+// -----------------------------------------------------------
+class CommandListPool
+{
+public:
+    CommandListPool() = default;
+
+    CommandListPool(const CommandListPool&) = delete;
+    CommandListPool& operator=(const CommandListPool&) = delete;
+
+    bool Initialize(ID3D12Device* device, D3D12_COMMAND_LIST_TYPE type);
+    void Shutdown();
+
+    /// Returns an open command list ready for recording, or nullptr on failure.
+    /// completedFence is the value the GPU has already passed.
+    ID3D12GraphicsCommandList* Acquire(UINT64 completedFence, ID3D12PipelineState* initialState = nullptr);
+
+    /// Returns one list after submission, keyed by its fence value.
+    void Release(ID3D12GraphicsCommandList* list, UINT64 fenceValue);
+
+    /// Returns every list acquired since the last release.
+    void ReleaseAll(UINT64 fenceValue);
+
+    D3D12_COMMAND_LIST_TYPE Type() const { return m_type; }
+    size_t TotalCount() const { return m_free.size() + m_inFlight.size(); }
+
+private:
+    struct Entry
+    {
+        ComPtr<ID3D12CommandAllocator> allocator;
+        ComPtr<ID3D12GraphicsCommandList> list;
+        UINT64 fenceValue = 0;
+    };
+
+private:
+    ID3D12Device* m_device = nullptr;
+    D3D12_COMMAND_LIST_TYPE m_type = D3D12_COMMAND_LIST_TYPE_DIRECT;
+
+    std::mutex m_mutex;
+    std::vector<Entry> m_free;      ///< submitted, waiting for their fence
+    std::vector<Entry> m_inFlight;  ///< acquired, not yet released
+};
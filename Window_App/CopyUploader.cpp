@@ -0,0 +1,266 @@
+#include "CopyUploader.h"
+#include <cstring>
+#include <vector>
+#include "d3dx12.h"
+
+namespace
+{
+    // CopyBufferRegion has no alignment rules; keep staging 16-byte aligned for memcpy
+    const UINT64 kStagingAlignment = 16;
+}
+
+// -----------------------------------------------------------
+// Setup / teardown
+// -----------------------------------------------------------
+bool CopyUploader::Initialize(ID3D12Device* device, QueueScheduler* queues, UINT64 stagingBytes)
+{
+    m_device = device;
+    m_queues = queues;
+    if (!m_pool.Initialize(device, D3D12_COMMAND_LIST_TYPE_COPY)) return false;
+    return m_staging.Initialize(device, stagingBytes, L"Copy Staging Ring");
+}
+
+void CopyUploader::Shutdown()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_list)
+    {
+        m_list->Close();
+        m_list = nullptr;
+    }
+    if (m_queues)
+        m_queues->WaitCpu(m_lastSubmitted);
+    m_pool.Shutdown();
+    m_staging.Shutdown();
+}
+
+// -----------------------------------------------------------
+// Upload
+// -----------------------------------------------------------
+bool CopyUploader::OpenListLocked()
+{
+    if (m_list) return true;
+    m_list = m_pool.Acquire(m_queues->CompletedValue(QueueType::Copy));
+    return m_list != nullptr;
+}
+
+bool CopyUploader::StageLocked(UINT64 size, UINT64 alignment, UploadRing::Allocation& out)
+{
+    m_staging.Reclaim(m_queues->CompletedValue(QueueType::Copy));
+    out = m_staging.Allocate(size, alignment);
+    if (!out)
+    {
+        // Staging is full: submit what is queued and wait for the copy
+        // queue to drain it (blocks this thread only)
+        FlushLocked();
+        m_queues->WaitCpu(m_lastSubmitted);
+        m_staging.Reclaim(m_queues->CompletedValue(QueueType::Copy));
+
+        out = m_staging.Allocate(size, alignment);
+        if (!out) return false;
+    }
+    return OpenListLocked();
+}
+
+bool CopyUploader::Upload(ID3D12Resource* dst, UINT64 dstOffset, const void* data, UINT64 size)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    const UINT8* src = static_cast<const UINT8*>(data);
+    const UINT64 maxChunk = m_staging.Allocator().Capacity() / 2;
+
+    while (size > 0)
+    {
+        const UINT64 chunk = size < maxChunk ? size : maxChunk;
+
+        UploadRing::Allocation staging;
+        if (!StageLocked(chunk, kStagingAlignment, staging)) return false;
+
+        memcpy(staging.cpu, src, static_cast<size_t>(chunk));
+        m_list->CopyBufferRegion(dst, dstOffset, staging.resource, staging.offset, chunk);
+
+        src += chunk;
+        dstOffset += chunk;
+        size -= chunk;
+        m_bytesUploaded += chunk;
+    }
+    return true;
+}
+
+bool CopyUploader::UploadTexture(ID3D12Resource* dst, UINT firstSubresource, UINT count, const D3D12_SUBRESOURCE_DATA* data)
+{
+    const TextureUpload upload{ dst, firstSubresource, count, data };
+    return UploadTextures(&upload, 1);
+}
+
+bool CopyUploader::UploadTextures(const TextureUpload* uploads, UINT count)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    // Runs of subresources that share the staging allocation, and the
+    // oversized ones that are copied row piece by row piece
+    struct Run
+    {
+        TextureUpload upload;
+        UINT64 offset;
+    };
+    std::vector<Run> runs;
+    std::vector<TextureUpload> oversized;
+    const UINT64 maxChunk = MaxBatchBytes();
+    UINT64 total = 0;
+
+    for (UINT i = 0; i < count; ++i)
+    {
+        const TextureUpload& u = uploads[i];
+        for (UINT s = 0; s < u.count;)
+        {
+            if (GetRequiredIntermediateSize(u.dst, u.firstSubresource + s, 1) > maxChunk)
+            {
+                oversized.push_back({ u.dst, u.firstSubresource + s, 1, u.data + s });
+                ++s;
+                continue;
+            }
+
+            UINT end = s + 1;
+            while (end < u.count && GetRequiredIntermediateSize(u.dst, u.firstSubresource + end, 1) <= maxChunk)
+                ++end;
+
+            runs.push_back({ { u.dst, u.firstSubresource + s, end - s, u.data + s }, total });
+            total += GetRequiredIntermediateSize(u.dst, u.firstSubresource + s, end - s);
+            total = (total + D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT - 1) & ~static_cast<UINT64>(D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT - 1);
+            s = end;
+        }
+    }
+
+    // Fail before anything is queued: a single row must fit a piece
+    for (const TextureUpload& u : oversized)
+    {
+        const D3D12_RESOURCE_DESC desc = u.dst->GetDesc();
+        D3D12_PLACED_SUBRESOURCE_FOOTPRINT footprint;
+        m_device->GetCopyableFootprints(&desc, u.firstSubresource, 1, 0, &footprint, nullptr, nullptr, nullptr);
+        if (footprint.Footprint.RowPitch > maxChunk) return false;
+    }
+
+    if (!runs.empty())
+    {
+        UploadRing::Allocation staging;
+        if (!StageLocked(total, D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT, staging)) return false;
+
+        for (const Run& run : runs)
+        {
+            const TextureUpload& u = run.upload;
+            if (UpdateSubresources(m_list, u.dst, staging.resource, staging.offset + run.offset,
+                    u.firstSubresource, u.count, u.data) == 0)
+                return false;
+        }
+        m_bytesUploaded += total;
+    }
+
+    for (const TextureUpload& u : oversized)
+    {
+        if (!UploadRowsLocked(u.dst, u.firstSubresource, *u.data))
+            return false;
+    }
+    return true;
+}
+
+bool CopyUploader::UploadRowsLocked(ID3D12Resource* dst, UINT subresource, const D3D12_SUBRESOURCE_DATA& data)
+{
+    const D3D12_RESOURCE_DESC desc = dst->GetDesc();
+    D3D12_PLACED_SUBRESOURCE_FOOTPRINT footprint;
+    UINT rowCount = 0;
+    UINT64 rowBytes = 0;
+    m_device->GetCopyableFootprints(&desc, subresource, 1, 0, &footprint, &rowCount, &rowBytes, nullptr);
+
+    // Rows are block rows for compressed formats
+    const UINT64 rowPitch = footprint.Footprint.RowPitch;
+    const UINT rowHeight = rowCount ? footprint.Footprint.Height / rowCount : 1;
+    const UINT rowsPerPiece = static_cast<UINT>(MaxBatchBytes() / rowPitch);
+
+    D3D12_TEXTURE_COPY_LOCATION dstLocation{};
+    dstLocation.pResource = dst;
+    dstLocation.Type = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX;
+    dstLocation.SubresourceIndex = subresource;
+
+    for (UINT z = 0; z < footprint.Footprint.Depth; ++z)
+    {
+        const UINT8* slice = static_cast<const UINT8*>(data.pData) + z * data.SlicePitch;
+        for (UINT row = 0; row < rowCount;)
+        {
+            const UINT rows = rowCount - row < rowsPerPiece ? rowCount - row : rowsPerPiece;
+
+            UploadRing::Allocation staging;
+            if (!StageLocked(rows * rowPitch, D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT, staging)) return false;
+            for (UINT r = 0; r < rows; ++r)
+                memcpy(staging.cpu + r * rowPitch, slice + (row + r) * data.RowPitch, static_cast<size_t>(rowBytes));
+
+            D3D12_TEXTURE_COPY_LOCATION srcLocation{};
+            srcLocation.pResource = staging.resource;
+            srcLocation.Type = D3D12_TEXTURE_COPY_TYPE_PLACED_FOOTPRINT;
+            srcLocation.PlacedFootprint.Offset = staging.offset;
+            srcLocation.PlacedFootprint.Footprint = footprint.Footprint;
+            srcLocation.PlacedFootprint.Footprint.Height = rows * rowHeight;
+            srcLocation.PlacedFootprint.Footprint.Depth = 1;
+
+            m_list->CopyTextureRegion(&dstLocation, 0, row * rowHeight, z, &srcLocation, nullptr);
+
+            m_bytesUploaded += rows * rowPitch;
+            row += rows;
+        }
+    }
+    return true;
+}
+
+bool CopyUploader::UploadTiles(ID3D12Resource* dst, const D3D12_TILED_RESOURCE_COORDINATE& start,
+    UINT tileCount, const void* data)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    const UINT64 size = static_cast<UINT64>(tileCount) * D3D12_TILED_RESOURCE_TILE_SIZE_IN_BYTES;
+    UploadRing::Allocation staging;
+    if (!StageLocked(size, D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT, staging)) return false;
+
+    memcpy(staging.cpu, data, static_cast<size_t>(size));
+
+    D3D12_TILE_REGION_SIZE region{};
+    region.NumTiles = tileCount;
+    D3D12_TILED_RESOURCE_COORDINATE coord = start;
+    m_list->CopyTiles(dst, &coord, &region, staging.resource, staging.offset,
+        D3D12_TILE_COPY_FLAG_LINEAR_BUFFER_TO_SWIZZLED_TILED_RESOURCE);
+
+    m_bytesUploaded += size;
+    return true;
+}
+
+TimelinePoint CopyUploader::Flush()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return FlushLocked();
+}
+
+TimelinePoint CopyUploader::FlushLocked()
+{
+    if (!m_list) return { QueueType::Copy, 0 };
+
+    m_list->Close();
+    ID3D12CommandList* lists[] = { m_list };
+    const TimelinePoint done = m_queues->Submit(QueueType::Copy, 1, lists);
+
+    m_pool.ReleaseAll(done.value);
+    m_staging.Seal(done.value);
+    m_list = nullptr;
+    m_lastSubmitted = done;
+    return done;
+}
+
+TimelinePoint CopyUploader::LastSubmitted() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_lastSubmitted;
+}
+
+void CopyUploader::Retire()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_staging.Reclaim(m_queues->CompletedValue(QueueType::Copy));
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <windows.h>
+#include <wrl.h>
+#include <d3d12.h>
+#include <mutex>
+
+#include "CommandListPool.h"
+#include "QueueScheduler.h"
+#include "UploadRing.h"
+
+using Microsoft::WRL::ComPtr;
+
+// Subresources of one texture for CopyUploader::UploadTextures
+struct TextureUpload
+{
+    ID3D12Resource* dst = nullptr;
+    UINT firstSubresource = 0;
+    UINT count = 0;
+    const D3D12_SUBRESOURCE_DATA* data = nullptr;   ///< count entries
+};
+
+// -----------------------------------------------------------
+// CopyUploader
+//   Streams data into DEFAULT-heap buffers, textures and tiles of
+//   reserved resources on the copy queue.
+//   Source bytes are staged in an upload ring, copies are batched
+//   into one copy list and submitted by Flush(), which returns the
+//   copy-queue timeline point that marks their completion. Callers
+//   gate use of the destination on that point (IsComplete on the
+//   CPU, or as a dependency of a later Submit).
+//
+//   A texture subresource too large for one staging allocation is
+//   copied in pieces of rows (per depth slice), like large buffers.
+//
+//   Destinations must be in COMMON; they are promoted to
+//   COPY_DEST by the copy and decay back to COMMON afterwards, so
+//   the direct queue can read them without a barrier.
+//
+//   Internally locked; any thread may upload. A full staging ring
+//   only blocks the uploading thread.
+// -----------------------------------------------------------
+class CopyUploader
+{
+public:
+    CopyUploader() = default;
+
+    CopyUploader(const CopyUploader&) = delete;
+    CopyUploader& operator=(const CopyUploader&) = delete;
+
+    bool Initialize(ID3D12Device* device, QueueScheduler* queues, UINT64 stagingBytes);
+    void Shutdown();
+
+    /// Queues a copy of `size` bytes into dst at dstOffset.
+    bool Upload(ID3D12Resource* dst, UINT64 dstOffset, const void* data, UINT64 size);
+
+    /// Queues copies of subresources (rows of RowPitch bytes).
+    bool UploadTexture(ID3D12Resource* dst, UINT firstSubresource, UINT count, const D3D12_SUBRESOURCE_DATA* data);
+
+    /// Several textures through one staging allocation; subresources
+    /// larger than MaxBatchBytes() are split into row pieces. Nothing is
+    /// queued if staging fails.
+    bool UploadTextures(const TextureUpload* uploads, UINT count);
+
+    /// Largest single staging allocation (half the ring).
+    UINT64 MaxBatchBytes() const { return m_staging.Allocator().Capacity() / 2; }
+
+    /// Queues a copy of `tileCount` linear 64KB tiles into mapped tiles of a reserved resource.
+    bool UploadTiles(ID3D12Resource* dst, const D3D12_TILED_RESOURCE_COORDINATE& start,
+        UINT tileCount, const void* data);
+
+    /// Submits everything queued so far; returns the point to wait for
+    /// (value 0 if nothing was queued since the last flush).
+    TimelinePoint Flush();
+
+    /// Point that completes all submitted uploads.
+    TimelinePoint LastSubmitted() const;
+
+    /// Releases staging space of finished batches.
+    void Retire();
+
+    UINT64 BytesUploaded() const { return m_bytesUploaded; }
+
+private:
+    TimelinePoint FlushLocked();
+    bool OpenListLocked();
+    bool StageLocked(UINT64 size, UINT64 alignment, UploadRing::Allocation& out);
+    bool UploadRowsLocked(ID3D12Resource* dst, UINT subresource, const D3D12_SUBRESOURCE_DATA& data);
+
+private:
+    ID3D12Device* m_device = nullptr;
+    QueueScheduler* m_queues = nullptr;
+    CommandListPool m_pool;
+    UploadRing m_staging;
+
+    mutable std::mutex m_mutex;
+    ID3D12GraphicsCommandList* m_list = nullptr;    ///< open batch, nullptr = none
+    TimelinePoint m_lastSubmitted{ QueueType::Copy, 0 };
+    UINT64 m_bytesUploaded = 0;
+};
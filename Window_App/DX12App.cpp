@@ -5,18 +5,53 @@
 
 using namespace DirectX;
 
+namespace
+{
+    // How often an idle render thread re-checks what it cannot be woken for:
+    // occlusion ending, or geometry uploads completing
+    const DWORD kIdlePollMs = 100;
+
+    UINT64 QueryTicks()
+    {
+        LARGE_INTEGER t;
+        QueryPerformanceCounter(&t);
+        return static_cast<UINT64>(t.QuadPart);
+    }
+}
+
 // -----------------------------------------------------------
 // Constructor / Destructor
 // -----------------------------------------------------------
-DX12App::DX12App(HWND hwnd, UINT width, UINT height)
-    : m_hWnd(hwnd), m_width(width), m_height(height)
+DX12App::DX12App(HWND hwnd, UINT width, UINT height, const DX12AppSettings& settings)
+    : m_hWnd(hwnd), m_width(width), m_height(height), m_settings(settings)
 {
+    m_frames.Resize(m_settings.frameCount);
+    m_settings.frameCount = m_frames.FrameCount();
+
+    if (m_settings.maxFrameLatency < 1) m_settings.maxFrameLatency = 1;
+    if (m_settings.maxFrameLatency > 3) m_settings.maxFrameLatency = 3;
+
+    LARGE_INTEGER freq;
+    QueryPerformanceFrequency(&freq);
+    m_latency.SetFrequency(static_cast<UINT64>(freq.QuadPart));
+    m_pacer.SetTargetFps(m_settings.targetFps);
+
+    m_wakeEvent = CreateEventW(nullptr, FALSE, FALSE, nullptr);
 }
 
 DX12App::~DX12App()
 {
+    StopRenderThread();
+    m_uploader.Shutdown();
     WaitForGPU();
-    if (m_fenceEvent) CloseHandle(m_fenceEvent);
+    m_streamer.Shutdown();
+    m_textureLoader.Shutdown();
+    m_deferredRelease.Flush();
+    m_geometry.Shutdown();
+    m_recorder.Shutdown();
+    m_bundles.Shutdown();
+    if (m_frameLatencyWaitable) CloseHandle(m_frameLatencyWaitable);
+    if (m_wakeEvent) CloseHandle(m_wakeEvent);
 }
 
 // -----------------------------------------------------------
@@ -39,11 +74,39 @@ if (!SelectAdapter()) return false;
 if (!CreateDevice()) return false;
 if (!CreateCommandQueue()) return false;
 if (!CreateSwapChain()) return false;
-if (!CreateRTVHeap()) return false;
+if (!CreateDescriptorHeaps()) return false;
 if (!CreateRenderTargets()) return false;
-if (!CreateCommandAllocators()) return false;
-if (!CreateCommandList()) return false;
-if (!CreateFence()) return false;
+if (!CreateCommandPool()) return false;
+if (!CreateUploadRing()) return false;
+if (m_settings.residency)
+{
+    if (!m_residency.Initialize(m_device.Get(), m_adapter.Get())) return false;
+    m_gpuAllocator.SetResidencyManager(&m_residency);
+}
+if (!m_gpuAllocator.Initialize(m_device.Get())) return false;
+if (!m_uploader.Initialize(m_device.Get(), &m_queues, m_settings.stagingBytes)) return false;
+if (!m_geometry.Initialize(&m_gpuAllocator, &m_uploader, sizeof(Vertex))) return false;
+if (!m_streamer.Initialize(m_device.Get(), &m_queues, &m_uploader, &m_viewPool, &m_descriptorRing,
+    &m_deferredRelease, m_settings.streamingPoolBytes, m_settings.streamingBytesPerFrame)) return false;
+if (!m_textureLoader.Initialize(m_device.Get(), &m_queues, &m_uploader, &m_gpuAllocator, &m_viewPool,
+    &m_descriptorRing, &m_deferredRelease, m_settings.textureLoadBytesPerFrame)) return false;
+if (!CreateFrameTimestamps()) return false;
+if (!m_recorder.Initialize(m_device.Get(), D3D12_COMMAND_LIST_TYPE_DIRECT, m_settings.recordThreads)) return false;
+if (!m_bundles.Initialize(m_device.Get())) return false;
+
+if (m_settings.enhancedBarriers)
+{
+    // ΉfoCXł͏]̃\[XoAg
+    CD3DX12FeatureSupport features;
+    m_frameGraph.SetEnhancedBarriers(SUCCEEDED(features.Init(m_device.Get())) && features.EnhancedBarriersSupported());
+}
+
+if (m_settings.renderPasses)
+{
+    // ID3D12Device4 ΃R}hXg ID3D12GraphicsCommandList4 
+    ComPtr<ID3D12Device4> device4;
+    m_renderPasses = SUCCEEDED(m_device.As(&device4));
+}
 
 if (!CompileShaders()) return false;
 if (!CreateRootSignature()) return false;
@@ -63,7 +126,16 @@ bool DX12App::CreateFactory()
 #else
     UINT flags = 0;
 #endif
-    return SUCCEEDED(CreateDXGIFactory2(flags, IID_PPV_ARGS(&m_factory)));
+    if (FAILED(CreateDXGIFactory2(flags, IID_PPV_ARGS(&m_factory)))) return false;
+
+    if (m_settings.allowTearing)
+    {
+        // Ήł͒ʏ vsync Present ̂܂
+        BOOL allowTearing = FALSE;
+        if (SUCCEEDED(m_factory->CheckFeatureSupport(DXGI_FEATURE_PRESENT_ALLOW_TEARING, &allowTearing, sizeof(allowTearing))))
+            m_tearing = allowTearing == TRUE;
+    }
+    return true;
 }
 
 bool DX12App::SelectAdapter()
@@ -94,9 +166,7 @@ bool DX12App::CreateDevice()
 
 bool DX12App::CreateCommandQueue()
 {
-    D3D12_COMMAND_QUEUE_DESC desc{};
-    desc.Type = D3D12_COMMAND_LIST_TYPE_DIRECT;
-    return SUCCEEDED(m_device->CreateCommandQueue(&desc, IID_PPV_ARGS(&m_commandQueue)));
+    return m_queues.Initialize(m_device.Get());
 }
 
 // -----------------------------------------------------------
@@ -105,80 +175,179 @@ bool DX12App::CreateCommandQueue()
 bool DX12App::CreateSwapChain()
 {
     DXGI_SWAP_CHAIN_DESC1 desc{};
-    desc.BufferCount = 2;
+    desc.BufferCount = m_settings.frameCount;
     desc.Width = m_width;
     desc.Height = m_height;
     desc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
     desc.BufferUsage = DXGI_USAGE_RENDER_TARGET_OUTPUT;
-    desc.SwapEffect = DXGI_SWAP_EFFECT_FLIP_DISCARD;
+    //  Present (dirty rect)  FLIP_SEQUENTIAL ł̂ݗL
+    desc.SwapEffect = m_settings.damageTracking ? DXGI_SWAP_EFFECT_FLIP_SEQUENTIAL : DXGI_SWAP_EFFECT_FLIP_DISCARD;
     desc.SampleDesc.Count = 1;
+    if (m_settings.frameLatencyWaitable)
+        desc.Flags |= DXGI_SWAP_CHAIN_FLAG_FRAME_LATENCY_WAITABLE_OBJECT;
+    if (m_tearing)
+        desc.Flags |= DXGI_SWAP_CHAIN_FLAG_ALLOW_TEARING;
 
     ComPtr<IDXGISwapChain1> swapChain1;
-    if (FAILED(m_factory->CreateSwapChainForHwnd(m_commandQueue.Get(), m_hWnd, &desc, nullptr, nullptr, &swapChain1)))
+    if (FAILED(m_factory->CreateSwapChainForHwnd(m_queues.GetQueue(QueueType::Direct), m_hWnd, &desc, nullptr, nullptr, &swapChain1)))
         return false;
 
     if (FAILED(swapChain1.As(&m_swapChain))) return false;
 
+    // Tearing only works in windowed / borderless mode; keep Alt+Enter
+    // from switching to exclusive fullscreen
+    if (m_tearing)
+        m_factory->MakeWindowAssociation(m_hWnd, DXGI_MWA_NO_ALT_ENTER);
+
+    if (m_settings.frameLatencyWaitable)
+    {
+        // The budget caps how many frames may be queued for present;
+        // the handle is signaled whenever a new frame may be started.
+        if (FAILED(m_swapChain->SetMaximumFrameLatency(m_settings.maxFrameLatency)))
+            return false;
+
+        m_frameLatencyWaitable = m_swapChain->GetFrameLatencyWaitableObject();
+        if (!m_frameLatencyWaitable) return false;
+    }
+
+    m_damage.Reset(m_settings.frameCount, m_width, m_height);
+
     return true;
 }
 
-bool DX12App::CreateRTVHeap()
+bool DX12App::CreateDescriptorHeaps()
 {
-    D3D12_DESCRIPTOR_HEAP_DESC desc{};
-    desc.NumDescriptors = 2;
-    desc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_RTV;
-    desc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_NONE;
+    // CPU-only pools grow page by page; views are written there once
+    if (!m_rtvPool.Initialize(m_device.Get(), D3D12_DESCRIPTOR_HEAP_TYPE_RTV, 16)) return false;
+    if (!m_viewPool.Initialize(m_device.Get(), D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV)) return false;
 
-    if (FAILED(m_device->CreateDescriptorHeap(&desc, IID_PPV_ARGS(&m_rtvHeap))))
-        return false;
+    // Unbounded SRV/UAV tables need resource binding tier 2
+    if (m_settings.bindless)
+    {
+        D3D12_FEATURE_DATA_D3D12_OPTIONS options{};
+        if (SUCCEEDED(m_device->CheckFeatureSupport(D3D12_FEATURE_D3D12_OPTIONS, &options, sizeof(options))))
+            m_bindless = options.ResourceBindingTier >= D3D12_RESOURCE_BINDING_TIER_2;
+    }
 
-    m_rtvDescriptorSize = m_device->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_RTV);
-    return true;
+    // Without bindless, the frame constants view is rewritten here every
+    // frame and staged into the ring
+    if (!m_bindless)
+    {
+        m_frameCbv = m_viewPool.Allocate();
+        if (!m_frameCbv) return false;
+    }
+
+    // Shader-visible tables for every frame in flight, refilled per frame;
+    // the bindless table sits in front of them in the same heap
+    return m_descriptorRing.Initialize(m_device.Get(), m_settings.descriptorsPerFrame * m_frames.FrameCount(),
+        m_bindless ? m_settings.bindlessDescriptors : 0);
 }
 
 bool DX12App::CreateRenderTargets()
 {
-    for (UINT i = 0; i < 2; ++i)
+    for (UINT i = 0; i < m_settings.frameCount; ++i)
     {
         if (FAILED(m_swapChain->GetBuffer(i, IID_PPV_ARGS(&m_renderTargets[i]))))
             return false;
 
-        D3D12_CPU_DESCRIPTOR_HANDLE handle = m_rtvHeap->GetCPUDescriptorHandleForHeapStart();
-        handle.ptr += i * m_rtvDescriptorSize;
-        m_device->CreateRenderTargetView(m_renderTargets[i].Get(), nullptr, handle);
+        // Slots are kept across resizes and rewritten in place
+        if (!m_rtvs[i]) m_rtvs[i] = m_rtvPool.Allocate();
+        if (!m_rtvs[i]) return false;
+        m_device->CreateRenderTargetView(m_renderTargets[i].Get(), nullptr, m_rtvs[i].cpu);
     }
     return true;
 }
 
 // -----------------------------------------------------------
-// Command allocators / list / fence
+// Resize
 // -----------------------------------------------------------
-bool DX12App::CreateCommandAllocators()
+void DX12App::OnResize(UINT width, UINT height)
 {
-    for (UINT i = 0; i < 2; ++i)
+    // ŏ (0x0) ̓Xbv`FĈ܂܂ɂ
+    if (width == 0 || height == 0) return;
+
+    // Without a render thread the resize can be applied right away
+    if (!m_renderThread.joinable())
     {
-        if (FAILED(m_device->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_DIRECT, IID_PPV_ARGS(&m_commandAllocators[i]))))
-            return false;
+        if (!Resize(width, height))
+            OutputDebugStringA("DX12App: ResizeBuffers failed, keeping the previous size\n");
+        return;
     }
-    return true;
+
+    // Drag-resizing sends a burst of WM_SIZE; only the latest one matters
+    m_pendingResize.store((static_cast<UINT64>(width) << 32) | height, std::memory_order_relaxed);
+    Wake();
 }
 
-bool DX12App::CreateCommandList()
+bool DX12App::Resize(UINT width, UINT height)
 {
-    if (FAILED(m_device->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_DIRECT, m_commandAllocators[0].Get(), nullptr, IID_PPV_ARGS(&m_commandList))))
+    if (!m_swapChain || (width == m_width && height == m_height))
+        return true;
+
+    // Only direct-queue frames touch the back buffers; compute and copy
+    // work keeps running
+    m_queues.WaitCpu({ QueueType::Direct, m_frames.LastSignaledValue() });
+
+    for (UINT i = 0; i < m_settings.frameCount; ++i)
+        m_renderTargets[i].Reset();
+
+    // Keep buffer count, format and flags (waitable / tearing)
+    DXGI_SWAP_CHAIN_DESC1 desc{};
+    m_swapChain->GetDesc1(&desc);
+    if (FAILED(m_swapChain->ResizeBuffers(0, width, height, DXGI_FORMAT_UNKNOWN, desc.Flags)))
+    {
+        // The old buffers are still there; keep rendering at the old size
+        CreateRenderTargets();
         return false;
+    }
 
-    m_commandList->Close(); ///< ŏ͕Ă
-    return true;
+    m_width = width;
+    m_height = height;
+    m_damage.Reset(m_settings.frameCount, m_width, m_height);
+    m_sceneDirty = true;
+
+    // The RTVs are rewritten in their existing pool slots
+    return CreateRenderTargets();
 }
 
-bool DX12App::CreateFence()
+// -----------------------------------------------------------
+// Command list pool
+// -----------------------------------------------------------
+bool DX12App::CreateCommandPool()
 {
-    if (FAILED(m_device->CreateFence(0, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&m_fence))))
+    return m_commandPool.Initialize(m_device.Get(), D3D12_COMMAND_LIST_TYPE_DIRECT);
+}
+
+bool DX12App::CreateUploadRing()
+{
+    // One buffer for all frames in flight; frames that upload little
+    // leave the space to frames that upload more
+    return m_uploadRing.Initialize(m_device.Get(), m_settings.uploadBytesPerFrame * m_frames.FrameCount());
+}
+
+bool DX12App::CreateFrameTimestamps()
+{
+    if (FAILED(m_queues.GetQueue(QueueType::Direct)->GetTimestampFrequency(&m_timestampFrequency)))
+        return false;
+
+    D3D12_QUERY_HEAP_DESC heapDesc{};
+    heapDesc.Type = D3D12_QUERY_HEAP_TYPE_TIMESTAMP;
+    heapDesc.Count = kMaxFrameCount * 2;
+    if (FAILED(m_device->CreateQueryHeap(&heapDesc, IID_PPV_ARGS(&m_timestampHeap))))
+        return false;
+
+    CD3DX12_HEAP_PROPERTIES heap(D3D12_HEAP_TYPE_READBACK);
+    CD3DX12_RESOURCE_DESC desc = CD3DX12_RESOURCE_DESC::Buffer(heapDesc.Count * sizeof(UINT64));
+    if (FAILED(m_device->CreateCommittedResource(&heap, D3D12_HEAP_FLAG_NONE, &desc,
+        D3D12_RESOURCE_STATE_COPY_DEST, nullptr, IID_PPV_ARGS(&m_timestampReadback))))
         return false;
 
-    m_fenceEvent = CreateEvent(nullptr, FALSE, FALSE, nullptr);
-    return (m_fenceEvent != nullptr);
+    // Read only after the slot's fence has passed, so the mapping can stay open
+    void* data = nullptr;
+    if (FAILED(m_timestampReadback->Map(0, nullptr, &data)))
+        return false;
+    m_timestampCpu = static_cast<const UINT64*>(data);
+    return true;
 }
 
 // -----------------------------------------------------------
@@ -191,10 +360,16 @@ bool DX12App::CompileShaders()
     compileFlags |= D3DCOMPILE_DEBUG;
 #endif
 
-    if (FAILED(D3DCompileFromFile(L"VertexShader.hlsl", nullptr, nullptr, "VSMain", "vs_5_0", compileFlags, 0, &m_vsBlob, nullptr)))
+    // Resource arrays indexed by handle need shader model 5.1
+    const D3D_SHADER_MACRO bindlessDefines[] = { { "BINDLESS", "1" }, { nullptr, nullptr } };
+    const D3D_SHADER_MACRO* defines = m_bindless ? bindlessDefines : nullptr;
+    const char* vsTarget = m_bindless ? "vs_5_1" : "vs_5_0";
+    const char* psTarget = m_bindless ? "ps_5_1" : "ps_5_0";
+
+    if (FAILED(D3DCompileFromFile(L"VertexShader.hlsl", defines, D3D_COMPILE_STANDARD_FILE_INCLUDE, "VSMain", vsTarget, compileFlags, 0, &m_vsBlob, nullptr)))
         return false;
 
-    if (FAILED(D3DCompileFromFile(L"PixelShader.hlsl", nullptr, nullptr, "PSMain", "ps_5_0", compileFlags, 0, &m_psBlob, nullptr)))
+    if (FAILED(D3DCompileFromFile(L"PixelShader.hlsl", defines, D3D_COMPILE_STANDARD_FILE_INCLUDE, "PSMain", psTarget, compileFlags, 0, &m_psBlob, nullptr)))
         return false;
 
     return true;
@@ -205,7 +380,25 @@ bool DX12App::CompileShaders()
 // -----------------------------------------------------------
 bool DX12App::CreateRootSignature()
 {
+    if (m_bindless)
+        return CreateBindlessRootSignature();
+
+    // Frame constants (b1): a one-CBV table staged in the descriptor ring
+    D3D12_DESCRIPTOR_RANGE range{};
+    range.RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_CBV;
+    range.NumDescriptors = 1;
+    range.BaseShaderRegister = 1;
+
+    D3D12_ROOT_PARAMETER param{};
+    param.ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
+    param.DescriptorTable.NumDescriptorRanges = 1;
+    param.DescriptorTable.pDescriptorRanges = &range;
+    param.ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL;
+    m_frameConstantsParam = 0;
+
     D3D12_ROOT_SIGNATURE_DESC rsDesc{};
+    rsDesc.NumParameters = 1;
+    rsDesc.pParameters = &param;
     rsDesc.Flags = D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT;
 
     ComPtr<ID3DBlob> sig;
@@ -217,6 +410,48 @@ bool DX12App::CreateRootSignature()
     return SUCCEEDED(m_device->CreateRootSignature(0, sig->GetBufferPointer(), sig->GetBufferSize(), IID_PPV_ARGS(&m_rootSignature)));
 }
 
+// Bindless: root constants (b0) select resources by index in one unbounded
+// table that covers the whole persistent range of the descriptor ring.
+// The table is bound once per list; draws only change the constants.
+bool DX12App::CreateBindlessRootSignature()
+{
+    D3D12_FEATURE_DATA_ROOT_SIGNATURE version{ D3D_ROOT_SIGNATURE_VERSION_1_1 };
+    if (FAILED(m_device->CheckFeatureSupport(D3D12_FEATURE_ROOT_SIGNATURE, &version, sizeof(version))))
+        version.HighestVersion = D3D_ROOT_SIGNATURE_VERSION_1_0;
+
+    // Descriptors may be written until the list executes (streaming adds
+    // entries between frames); SRV contents are static while it runs
+    const D3D12_DESCRIPTOR_RANGE_FLAGS srvFlags =
+        D3D12_DESCRIPTOR_RANGE_FLAG_DESCRIPTORS_VOLATILE | D3D12_DESCRIPTOR_RANGE_FLAG_DATA_STATIC;
+    const D3D12_DESCRIPTOR_RANGE_FLAGS uavFlags = D3D12_DESCRIPTOR_RANGE_FLAG_DESCRIPTORS_VOLATILE;
+
+    // Every range starts at the table start, so handle i is slot i for every type
+    CD3DX12_DESCRIPTOR_RANGE1 ranges[3];
+    ranges[0].Init(D3D12_DESCRIPTOR_RANGE_TYPE_SRV, UINT_MAX, 0, 1, srvFlags, 0);   // Texture2D g_textures[]
+    ranges[1].Init(D3D12_DESCRIPTOR_RANGE_TYPE_SRV, UINT_MAX, 0, 2, srvFlags, 0);   // ByteAddressBuffer g_buffers[]
+    ranges[2].Init(D3D12_DESCRIPTOR_RANGE_TYPE_UAV, UINT_MAX, 0, 1, uavFlags, 0);   // RWByteAddressBuffer g_rwBuffers[]
+
+    CD3DX12_ROOT_PARAMETER1 params[3];
+    params[0].InitAsConstants(kDrawConstantCount, 0, 0, D3D12_SHADER_VISIBILITY_ALL);
+    params[1].InitAsDescriptorTable(_countof(ranges), ranges, D3D12_SHADER_VISIBILITY_ALL);
+    params[2].InitAsConstantBufferView(1, 0, D3D12_ROOT_DESCRIPTOR_FLAG_DATA_STATIC_WHILE_SET_AT_EXECUTE,
+        D3D12_SHADER_VISIBILITY_PIXEL);    // FrameConstants, from the upload ring
+    m_frameConstantsParam = 2;
+
+    CD3DX12_VERSIONED_ROOT_SIGNATURE_DESC rsDesc;
+    rsDesc.Init_1_1(_countof(params), params, 0, nullptr,
+        D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT);
+
+    ComPtr<ID3DBlob> sig;
+    ComPtr<ID3DBlob> err;
+
+    // Falls back to a 1.0 blob (flags dropped) on runtimes without 1.1
+    if (FAILED(D3DX12SerializeVersionedRootSignature(&rsDesc, version.HighestVersion, &sig, &err)))
+        return false;
+
+    return SUCCEEDED(m_device->CreateRootSignature(0, sig->GetBufferPointer(), sig->GetBufferSize(), IID_PPV_ARGS(&m_rootSignature)));
+}
+
 // -----------------------------------------------------------
 // Pipeline State
 // -----------------------------------------------------------
@@ -259,39 +494,14 @@ bool DX12App::CreateTriangleResources()
     };
 
     uint16_t indices[] = { 0,1,2 };
-    m_indexCount = _countof(indices);
-
-    // GPU upload heap gp
-    UINT vbSize = sizeof(vertices);
-    UINT ibSize = sizeof(indices);
 
-    CD3DX12_HEAP_PROPERTIES heap(D3D12_HEAP_TYPE_UPLOAD);
-    CD3DX12_RESOURCE_DESC vbDesc = CD3DX12_RESOURCE_DESC::Buffer(vbSize);
-    m_device->CreateCommittedResource(&heap, D3D12_HEAP_FLAG_NONE, &vbDesc,
-        D3D12_RESOURCE_STATE_GENERIC_READ, nullptr,
-        IID_PPV_ARGS(&m_vertexBuffer));
+    // LWIgobt@ɔzuARs[L[œ]
+    if (!m_geometry.AddMesh(vertices, _countof(vertices), indices, _countof(indices), m_triangle)) return false;
 
-    void* mapped = nullptr;
-    m_vertexBuffer->Map(0, nullptr, &mapped);
-    memcpy(mapped, vertices, vbSize);
-    m_vertexBuffer->Unmap(0, nullptr);
-
-    m_vertexBufferView.BufferLocation = m_vertexBuffer->GetGPUVirtualAddress();
-    m_vertexBufferView.SizeInBytes = vbSize;
-    m_vertexBufferView.StrideInBytes = sizeof(Vertex);
-
-    CD3DX12_RESOURCE_DESC ibDesc = CD3DX12_RESOURCE_DESC::Buffer(ibSize);
-    m_device->CreateCommittedResource(&heap, D3D12_HEAP_FLAG_NONE, &ibDesc,
-        D3D12_RESOURCE_STATE_GENERIC_READ, nullptr,
-        IID_PPV_ARGS(&m_indexBuffer));
-
-    m_indexBuffer->Map(0, nullptr, &mapped);
-    memcpy(mapped, indices, ibSize);
-    m_indexBuffer->Unmap(0, nullptr);
-
-    m_indexBufferView.BufferLocation = m_indexBuffer->GetGPUVirtualAddress();
-    m_indexBufferView.SizeInBytes = ibSize;
-    m_indexBufferView.Format = DXGI_FORMAT_R16_UINT;
+    // Drawn once the copy queue is done with it
+    const TimelinePoint ready = m_uploader.Flush();
+    m_geometry.MarkUsed(m_triangle.chunk, ready);
+    m_pendingDraws.push_back({ { m_triangle.indexCount, m_triangle.startIndex, m_triangle.baseVertex, m_triangle.chunk, kNoResource, TextureLoader::kInvalid }, ready });
 
     return true;
 }
@@ -301,30 +511,104 @@ bool DX12App::CreateTriangleResources()
 // -----------------------------------------------------------
 void DX12App::Render()
 {
+    // Wait for the swap chain before touching input so that the
+    // frame is recorded from the freshest possible state.
+    if (m_frameLatencyWaitable)
+        WaitForSingleObjectEx(m_frameLatencyWaitable, 1000, TRUE);
+
+    // Start as late as the predicted frame cost allows
+    m_pacer.WaitForFrameStart();
+
+    m_latency.SampleInput(QueryTicks());
+
+    // Retirement and streaming advance even when nothing is redrawn
+    UpdateFrameResources();
+
+    // Damage tracking: only the part of the back buffer that is older
+    // than the latest image gets redrawn
+    RECT repaint = { 0, 0, static_cast<LONG>(m_width), static_cast<LONG>(m_height) };
+    if (m_settings.damageTracking)
+    {
+        m_damage.BeginFrame();
+        repaint = m_damage.RepaintBounds();
+
+        // Every back buffer already holds the latest image
+        if (DamageTracker::IsEmpty(repaint))
+        {
+            static const std::vector<RECT> kUnchanged = { { 0, 0, 1, 1 } };
+            Present(&kUnchanged);
+            return;
+        }
+    }
+
     UINT backIndex = m_swapChain->GetCurrentBackBufferIndex();
 
-    if (m_fence->GetCompletedValue() < m_fenceValues[backIndex])
+    // Blocks only when every slot of the ring is still in flight
+    FenceWaiter waiter{ m_queues };
+    FrameContext& frame = m_frames.BeginFrame(waiter);
+
+    // The slot's previous frame has retired; feed its GPU time to the pacer
+    const UINT timestampIndex = m_frames.CurrentIndex() * 2;
+    if (frame.timestampsPending)
+    {
+        const UINT64 begin = m_timestampCpu[timestampIndex];
+        const UINT64 end = m_timestampCpu[timestampIndex + 1];
+        if (end > begin)
+            m_pacer.OnGpuCost(end - begin, m_timestampFrequency);
+        frame.timestampsPending = false;
+    }
+
+    const UINT64 completedFence = m_queues.CompletedValue(QueueType::Direct);
+    const UINT64 frameFence = m_queues.NextValue(QueueType::Direct);
+    m_bundles.Collect(completedFence);
+    m_uploadRing.Reclaim(completedFence);
+    m_descriptorRing.Reclaim(completedFence);
+
+    // Heaps this frame reads are paged in now; idle ones may be evicted
+    if (m_settings.residency)
     {
-        m_fence->SetEventOnCompletion(m_fenceValues[backIndex], m_fenceEvent);
-        WaitForSingleObject(m_fenceEvent, INFINITE);
+        MarkDrawsUsed(TimelinePoint{ QueueType::Direct, frameFence });
+        m_residency.Update(m_queues);
     }
 
-    m_commandAllocators[backIndex]->Reset();
-    m_commandList->Reset(m_commandAllocators[backIndex].Get(), m_pipelineState.Get());
+    // Frame constants live in the upload ring until this frame's fence passes
+    const UINT32 tint = m_sceneTint.load(std::memory_order_relaxed);
+    FrameConstants constants;
+    constants.tint.x = (tint & 0xFF) / 255.0f;
+    constants.tint.y = ((tint >> 8) & 0xFF) / 255.0f;
+    constants.tint.z = ((tint >> 16) & 0xFF) / 255.0f;
+    constants.tint.w = (tint >> 24) / 255.0f;
+    UploadRing::Allocation frameConstants = m_uploadRing.Push(&constants, sizeof(constants));
+    while (!frameConstants && WaitForOldestFrame())
+        frameConstants = m_uploadRing.Push(&constants, sizeof(constants));
+    if (!frameConstants)
+    {
+        AbandonFrame();
+        return;
+    }
+    m_frameConstants = frameConstants.gpu;
 
-    // Present  RenderTarget ֑J
-    CD3DX12_RESOURCE_BARRIER toRT = CD3DX12_RESOURCE_BARRIER::Transition(
-        m_renderTargets[backIndex].Get(),
-        D3D12_RESOURCE_STATE_PRESENT,
-        D3D12_RESOURCE_STATE_RENDER_TARGET);
-    m_commandList->ResourceBarrier(1, &toRT);
+    // The non-bindless root signature takes b1 as a table in the descriptor ring
+    if (!m_bindless)
+    {
+        const D3D12_CPU_DESCRIPTOR_HANDLE cbv = m_frameCbv.cpu;
+        D3D12_CONSTANT_BUFFER_VIEW_DESC cbvDesc{};
+        cbvDesc.BufferLocation = frameConstants.gpu;
+        cbvDesc.SizeInBytes = D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT;
+        m_device->CreateConstantBufferView(&cbvDesc, cbv);
 
-    D3D12_CPU_DESCRIPTOR_HANDLE rtv =
-        m_rtvHeap->GetCPUDescriptorHandleForHeapStart();
-    rtv.ptr += backIndex * m_rtvDescriptorSize;
+        DescriptorRing::Table table = m_descriptorRing.Stage(&cbv, 1);
+        while (!table && WaitForOldestFrame())
+            table = m_descriptorRing.Stage(&cbv, 1);
+        if (!table)
+        {
+            AbandonFrame();
+            return;
+        }
+        m_frameConstantsTable = table.gpu;
+    }
 
-    const float clearColor[] = { 0.2f, 0.2f, 0.2f, 1.0f };//̐lΐFςwîPő
-    m_commandList->ClearRenderTargetView(rtv, clearColor, 0, nullptr);
+    D3D12_CPU_DESCRIPTOR_HANDLE rtv = m_rtvs[backIndex].cpu;
 
     // Viewport / Scissor CŁiSj
     D3D12_VIEWPORT vp;
@@ -336,45 +620,522 @@ void DX12App::Render()
     vp.MaxDepth = 1.0f;
 
     D3D12_RECT scissor;
-    scissor.left = 0;
-    scissor.top = 0;
-    scissor.right = m_width;
-    scissor.bottom = m_height;
+    scissor.left = repaint.left;
+    scissor.top = repaint.top;
+    scissor.right = repaint.right;
+    scissor.bottom = repaint.bottom;
+
+    // Scene draws are split into one recording task per thread.
+    // Every task list sets its own state.
+    const UINT drawCount = static_cast<UINT>(m_drawItems.size());
+    UINT taskCount = m_recorder.WorkerCount();
+    if (taskCount > drawCount) taskCount = drawCount;
+    if (taskCount == 0) taskCount = 1;
+
+    // Render-pass path: the graph list opens the pass (clear) and suspends
+    // it, every task list resumes it and the last one ends it. All of them
+    // are submitted back to back in one ExecuteCommandLists call.
+    D3D12_RENDER_PASS_RENDER_TARGET_DESC sceneTarget{};
+
+    auto recordTask = [&](ID3D12GraphicsCommandList* list, UINT taskIndex)
+    {
+        ComPtr<ID3D12GraphicsCommandList4> passList;
+        if (m_renderPasses && SUCCEEDED(list->QueryInterface(IID_PPV_ARGS(&passList))))
+        {
+            D3D12_RENDER_PASS_FLAGS flags = D3D12_RENDER_PASS_FLAG_RESUMING_PASS;
+            if (taskIndex + 1 < taskCount)
+                flags |= D3D12_RENDER_PASS_FLAG_SUSPENDING_PASS;
+            passList->BeginRenderPass(1, &sceneTarget, nullptr, flags);
+        }
+        else
+        {
+            list->OMSetRenderTargets(1, &rtv, FALSE, nullptr);
+        }
+
+        list->RSSetViewports(1, &vp);
+        list->RSSetScissorRects(1, &scissor);
+        list->SetGraphicsRootSignature(m_rootSignature.Get());
+
+        // Bundles use the caller's descriptor heap
+        ID3D12DescriptorHeap* heap = m_descriptorRing.Heap();
+        list->SetDescriptorHeaps(1, &heap);
+
+        // Draw
+        const UINT first = drawCount * taskIndex / taskCount;
+        const UINT last = drawCount * (taskIndex + 1) / taskCount;
+
+        ID3D12GraphicsCommandList* bundle = nullptr;
+        if (m_settings.staticBundles)
+        {
+            bundle = m_bundles.Get(taskIndex, StaticDrawSignature(first, last), m_pipelineState.Get(),
+                [&](ID3D12GraphicsCommandList* b) { RecordStaticDraws(b, first, last); },
+                frameFence);
+        }
+
+        if (bundle)
+        {
+            // Cached bundles cannot hold per-frame addresses; they inherit the caller's
+            BindFrameConstants(list);
+            list->ExecuteBundle(bundle);
+        }
+        else
+            RecordStaticDraws(list, first, last);
+
+        if (passList)
+            passList->EndRenderPass();
+    };
+
+    // Frame graph: the back buffer is imported in PRESENT and handed back
+    // in PRESENT; every transition in between is derived from the passes.
+    m_frameGraph.Reset();
+    const FrameGraph::ResourceHandle backBuffer = m_frameGraph.Import("BackBuffer",
+        m_renderTargets[backIndex].Get(), D3D12_RESOURCE_STATE_PRESENT, D3D12_RESOURCE_STATE_PRESENT);
+
+    bool recorded = true;
+    FrameGraph::PassHandle scenePass = FrameGraph::kInvalid;
+    scenePass = m_frameGraph.AddPass("Scene", [&](FrameGraph::PassContext& ctx)
+    {
+        const float clearColor[] = { 0.2f, 0.2f, 0.2f, 1.0f };//̐lΐFςwîPő
+
+        ComPtr<ID3D12GraphicsCommandList4> passList;
+        if (m_renderPasses && SUCCEEDED(ctx.List()->QueryInterface(IID_PPV_ARGS(&passList))))
+        {
+            // Ot[̓e͓ǂ܂Ȃ̂ CLEARAPresent Ŏĝ PRESERVE
+            D3D12_CLEAR_VALUE clear{};
+            clear.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+            memcpy(clear.Color, clearColor, sizeof(clearColor));
+
+            // Damage tracking keeps the undamaged pixels: load them and
+            // clear only the repaint region
+            const bool partial = m_settings.damageTracking;
+            sceneTarget = m_frameGraph.RenderTargetAccess(scenePass, backBuffer, rtv, partial ? nullptr : &clear);
+
+            // Only the clear lives in this list; the task lists resume the pass
+            passList->BeginRenderPass(1, &sceneTarget, nullptr, D3D12_RENDER_PASS_FLAG_SUSPENDING_PASS);
+            if (partial)
+                passList->ClearRenderTargetView(rtv, clearColor, 1, &scissor);
+            passList->EndRenderPass();
+
+            // Later task lists load what the clear produced
+            sceneTarget.BeginningAccess.Type = D3D12_RENDER_PASS_BEGINNING_ACCESS_TYPE_PRESERVE;
+        }
+        else
+        {
+            ctx.List()->ClearRenderTargetView(rtv, clearColor, 1, &scissor);
+        }
+
+        recorded = m_recorder.Record(taskCount, recordTask, completedFence, m_pipelineState.Get(), m_sceneLists);
+        if (recorded)
+            ctx.Splice(static_cast<UINT>(m_sceneLists.size()), m_sceneLists.data());
+    });
+    m_frameGraph.Write(scenePass, backBuffer, D3D12_RESOURCE_STATE_RENDER_TARGET);
+    m_frameGraph.Compile();
+
+    m_submitLists.clear();
+    auto acquireList = [&]() { return m_commandPool.Acquire(completedFence, m_pipelineState.Get()); };
+
+    // Timestamps bracket the whole frame in two tiny lists of their own
+    ID3D12GraphicsCommandList* beginTiming = acquireList();
+    if (beginTiming)
+    {
+        beginTiming->EndQuery(m_timestampHeap.Get(), D3D12_QUERY_TYPE_TIMESTAMP, timestampIndex);
+        beginTiming->Close();
+        m_submitLists.push_back(beginTiming);
+    }
+
+    if (!m_frameGraph.Execute(m_device.Get(), acquireList, m_submitLists, completedFence, frameFence) || !recorded)
+    {
+        // Nothing was submitted, so the lists can be reused right away
+        AbandonFrame();
+        return;
+    }
+
+    ID3D12GraphicsCommandList* endTiming = beginTiming ? acquireList() : nullptr;
+    if (endTiming)
+    {
+        endTiming->EndQuery(m_timestampHeap.Get(), D3D12_QUERY_TYPE_TIMESTAMP, timestampIndex + 1);
+        endTiming->ResolveQueryData(m_timestampHeap.Get(), D3D12_QUERY_TYPE_TIMESTAMP, timestampIndex, 2,
+            m_timestampReadback.Get(), timestampIndex * sizeof(UINT64));
+        endTiming->Close();
+        m_submitLists.push_back(endTiming);
+        frame.timestampsPending = true;
+    }
+
+    // Tables staged while recording must be filled before the GPU reads them
+    m_descriptorRing.Flush();
+
+    // One submission, in graph order
+    const TimelinePoint done = m_queues.Submit(QueueType::Direct,
+        static_cast<UINT>(m_submitLists.size()), m_submitLists.data());
+
+    m_commandPool.ReleaseAll(done.value);
+    m_recorder.Retire(done.value);
+    m_uploadRing.Seal(done.value);
+    m_descriptorRing.Seal(done.value);
+    m_frames.EndFrame(done.value);
+
+    Present(m_settings.damageTracking ? &m_damage.FrameRects() : nullptr);
+}
+
+// Per-frame maintenance that must not depend on the frame being recorded:
+// finished copies and deferred releases are retired, landed draws are
+// promoted, and texture loads and tile streaming take their next step.
+// Streaming uses the next Direct fence, which the next recorded frame signals.
+void DX12App::UpdateFrameResources()
+{
+    const UINT64 completedFence = m_queues.CompletedValue(QueueType::Direct);
+    m_uploadRing.Reclaim(completedFence);
+    m_descriptorRing.Reclaim(completedFence);
+    m_uploader.Retire();
+    m_deferredRelease.Retire(m_queues);
+    PromoteReadyDraws();
+    m_streamer.Update(m_queues.NextValue(QueueType::Direct), completedFence);
+    m_textureLoader.Update();
+}
+
+// Blocks until the oldest Direct submission still in flight retires and
+// hands its ring space back. Returns false when nothing is in flight.
+bool DX12App::WaitForOldestFrame()
+{
+    const UINT64 completedFence = m_queues.CompletedValue(QueueType::Direct);
+    if (completedFence >= m_queues.LastSubmitted(QueueType::Direct)) return false;
+
+    m_queues.WaitCpu(TimelinePoint{ QueueType::Direct, completedFence + 1 });
+
+    const UINT64 retired = m_queues.CompletedValue(QueueType::Direct);
+    m_uploadRing.Reclaim(retired);
+    m_descriptorRing.Reclaim(retired);
+    return true;
+}
+
+// Closes a frame that submitted nothing. Lists and ring space taken so far
+// are released at the completed fence, the frame slot moves on, and the
+// next frame redraws everything since this one never reached the back buffer.
+void DX12App::AbandonFrame()
+{
+    const UINT64 completedFence = m_queues.CompletedValue(QueueType::Direct);
+    m_commandPool.ReleaseAll(completedFence);
+    m_recorder.Retire(completedFence);
+    m_uploadRing.Seal(completedFence);
+    m_descriptorRing.Flush();
+    m_descriptorRing.Seal(completedFence);
+    m_frames.EndFrame(completedFence);
+    m_damage.AddFull();
+    m_sceneDirty = true;
+}
+
+void DX12App::Present(const std::vector<RECT>* dirtyRects)
+{
+    const UINT syncInterval = m_tearing ? 0 : 1;
+    const UINT flags = m_tearing ? DXGI_PRESENT_ALLOW_TEARING : 0;
+
+    HRESULT hr;
+    if (dirtyRects && !dirtyRects->empty())
+    {
+        // Composition only has to pick up the changed rectangles
+        DXGI_PRESENT_PARAMETERS params{};
+        params.DirtyRectsCount = static_cast<UINT>(dirtyRects->size());
+        params.pDirtyRects = const_cast<RECT*>(dirtyRects->data());
+        hr = m_swapChain->Present1(syncInterval, flags, &params);
+    }
+    else
+    {
+        hr = m_swapChain->Present(syncInterval, flags);
+    }
+    const UINT64 now = QueryTicks();
+    m_latency.OnPresent(now);
+    m_pacer.OnPresent(now);
+
+    // ŏESɉBĂԂ͕`悵Ă\Ȃ
+    m_occluded = hr == DXGI_STATUS_OCCLUDED;
+    if (hr == S_OK) m_sceneDirty = false;
+}
+
+// -----------------------------------------------------------
+// Render thread
+// -----------------------------------------------------------
+bool DX12App::StartRenderThread()
+{
+    if (m_renderThreadRunning) return true;
+
+    m_renderThreadRunning = true;
+    m_renderThread = std::thread(&DX12App::RenderThreadMain, this);
+    return true;
+}
+
+void DX12App::StopRenderThread()
+{
+    if (!m_renderThread.joinable()) return;
+
+    m_renderThreadRunning = false;
+    Wake();
+    m_renderThread.join();
+}
+
+bool DX12App::PostEvent(const AppEvent& ev)
+{
+    if (!m_events.Push(ev)) return false;
+    Wake();
+    return true;
+}
+
+void DX12App::RenderThreadMain()
+{
+    while (m_renderThreadRunning)
+    {
+        ProcessEvents();
+
+        // Idle: sleep until an event, a resize or an animation needs a frame.
+        // An occluded window, or one waiting for uploads, wakes up periodically.
+        if (m_settings.idleMode && !ShouldRender())
+        {
+            const bool poll = m_occluded || !m_pendingDraws.empty();
+            WaitForSingleObject(m_wakeEvent, poll ? kIdlePollMs : INFINITE);
+            continue;
+        }
+
+        Render();
+    }
+}
+
+bool DX12App::ShouldRender()
+{
+    if (m_occluded)
+    {
+        // DXGI_PRESENT_TEST checks visibility without presenting anything
+        if (m_swapChain->Present(0, DXGI_PRESENT_TEST) == DXGI_STATUS_OCCLUDED)
+            return false;
+
+        // Whatever changed while hidden is redrawn in full
+        m_occluded = false;
+        m_sceneDirty = true;
+        m_damage.AddFull();
+    }
+
+    if (PromoteReadyDraws())
+        return true;
+
+    // Texture loads and tile streaming only advance inside Render,
+    // which runs them even on frames with no damage to redraw
+    if (m_textureLoader.IsBusy() || m_streamer.IsBusy())
+        return true;
+
+    if (m_animating.load(std::memory_order_relaxed))
+        return true;
+
+    return m_settings.damageTracking ? m_damage.NeedsRepaint() : m_sceneDirty;
+}
+
+bool DX12App::PromoteReadyDraws()
+{
+    bool promoted = false;
+    for (size_t i = 0; i < m_pendingDraws.size();)
+    {
+        if (!m_queues.IsComplete(m_pendingDraws[i].ready))
+        {
+            ++i;
+            continue;
+        }
+
+        m_drawItems.push_back(m_pendingDraws[i].item);
+        m_pendingDraws.erase(m_pendingDraws.begin() + i);
+        promoted = true;
+    }
+
+    // New geometry has no screen bounds yet; redraw everything
+    if (promoted)
+    {
+        m_damage.AddFull();
+        m_sceneDirty = true;
+    }
+    return promoted;
+}
+
+void DX12App::Wake()
+{
+    if (m_wakeEvent) SetEvent(m_wakeEvent);
+}
+
+void DX12App::SetAnimating(bool animating)
+{
+    m_animating.store(animating, std::memory_order_relaxed);
+    Wake();
+}
+
+void DX12App::SetSceneTint(float r, float g, float b, float a)
+{
+    auto channel = [](float v) { return static_cast<UINT32>((v < 0.0f ? 0.0f : v > 1.0f ? 1.0f : v) * 255.0f + 0.5f); };
+    m_sceneTint.store(channel(r) | (channel(g) << 8) | (channel(b) << 16) | (channel(a) << 24),
+        std::memory_order_relaxed);
+
+    // Every pixel changes
+    m_pendingFullDamage.store(true, std::memory_order_relaxed);
+    Wake();
+}
+
+void DX12App::ProcessEvents()
+{
+    const UINT64 size = m_pendingResize.exchange(0, std::memory_order_relaxed);
+    // A failed resize keeps the old size; the next WM_SIZE tries again
+    if (size && !Resize(static_cast<UINT>(size >> 32), static_cast<UINT>(size & 0xFFFFFFFF)))
+        OutputDebugStringA("DX12App: ResizeBuffers failed, keeping the previous size\n");
+
+    if (m_pendingFullDamage.exchange(false, std::memory_order_relaxed))
+    {
+        m_damage.AddFull();
+        m_sceneDirty = true;
+    }
 
-    m_commandList->RSSetViewports(1, &vp);
-    m_commandList->RSSetScissorRects(1, &scissor);
+    AppEvent ev;
+    while (m_events.Pop(ev))
+    {
+        switch (ev.type)
+        {
+        case AppEvent::Type::Input:
+            m_latency.OnInput(ev.time);
+            break;
+
+        case AppEvent::Type::Damage:
+            m_damage.Add(ev.rect);
+            m_sceneDirty = true;
+            break;
+        }
+    }
+}
 
-    // Draw
-    m_commandList->SetPipelineState(m_pipelineState.Get());
-    m_commandList->SetGraphicsRootSignature(m_rootSignature.Get());
-    m_commandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-    m_commandList->IASetVertexBuffers(0, 1, &m_vertexBufferView);
-    m_commandList->IASetIndexBuffer(&m_indexBufferView);
-    m_commandList->OMSetRenderTargets(1, &rtv, FALSE, nullptr);
-    m_commandList->DrawIndexedInstanced(m_indexCount, 1, 0, 0, 0);
+void DX12App::OnInput()
+{
+    AppEvent ev;
+    ev.type = AppEvent::Type::Input;
+    ev.time = QueryTicks();
 
-    // RenderTarget  Present ֖߂
-    CD3DX12_RESOURCE_BARRIER toPresent = CD3DX12_RESOURCE_BARRIER::Transition(
-        m_renderTargets[backIndex].Get(),
-        D3D12_RESOURCE_STATE_RENDER_TARGET,
-        D3D12_RESOURCE_STATE_PRESENT);
-    m_commandList->ResourceBarrier(1, &toPresent);
+    // Without a render thread there is nobody to drain the queue
+    if (!m_renderThread.joinable() || !PostEvent(ev))
+        m_latency.OnInput(ev.time);
+}
 
-    m_commandList->Close();
-    ID3D12CommandList* lists[] = { m_commandList.Get() };
-    m_commandQueue->ExecuteCommandLists(1, lists);
+void DX12App::Invalidate(const RECT& rect)
+{
+    if (!m_renderThread.joinable())
+    {
+        m_damage.Add(rect);
+        m_sceneDirty = true;
+        return;
+    }
 
-    ++m_fenceValue;
-    m_commandQueue->Signal(m_fence.Get(), m_fenceValue);
-    m_fenceValues[backIndex] = m_fenceValue;
+    AppEvent ev;
+    ev.type = AppEvent::Type::Damage;
+    ev.time = QueryTicks();
+    ev.rect = rect;
 
-    m_swapChain->Present(1, 0);
+    // A lost rectangle would leave stale pixels; redraw everything instead
+    if (!PostEvent(ev))
+    {
+        m_pendingFullDamage.store(true, std::memory_order_relaxed);
+        Wake();
+    }
+}
+
+// Static draw sequence, recorded either directly or into a bundle
+void DX12App::RecordStaticDraws(ID3D12GraphicsCommandList* list, UINT firstItem, UINT lastItem)
+{
+    list->SetGraphicsRootSignature(m_rootSignature.Get());
+    list->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+    if (list->GetType() != D3D12_COMMAND_LIST_TYPE_BUNDLE)
+        BindFrameConstants(list);
+
+    // One table for every draw; bundles must repeat the caller's heap
+    if (m_bindless)
+    {
+        if (list->GetType() == D3D12_COMMAND_LIST_TYPE_BUNDLE)
+        {
+            ID3D12DescriptorHeap* heap = m_descriptorRing.Heap();
+            list->SetDescriptorHeaps(1, &heap);
+        }
+        list->SetGraphicsRootDescriptorTable(1, m_descriptorRing.Reserved(0).gpu);
+    }
+
+    // Rebind only when the draws cross into another geometry chunk
+    UINT32 boundChunk = TlsfAllocator::kInvalid;
+    for (UINT i = firstItem; i < lastItem; ++i)
+    {
+        const DrawItem& item = m_drawItems[i];
+        if (item.chunk != boundChunk)
+        {
+            list->IASetVertexBuffers(0, 1, &m_geometry.VertexView(item.chunk));
+            list->IASetIndexBuffer(&m_geometry.IndexView(item.chunk));
+            boundChunk = item.chunk;
+        }
+        if (m_bindless)
+            list->SetGraphicsRoot32BitConstant(0, item.resource, 0);
+        list->DrawIndexedInstanced(item.indexCount, 1, item.startIndex, item.baseVertex, 0);
+    }
+}
+
+// Only what this frame's draws read counts as used; the rest ages out (LRU)
+void DX12App::MarkDrawsUsed(const TimelinePoint& frame)
+{
+    UINT32 markedChunk = TlsfAllocator::kInvalid;
+    for (const DrawItem& item : m_drawItems)
+    {
+        if (item.chunk != markedChunk)
+        {
+            m_geometry.MarkUsed(item.chunk, frame);
+            markedChunk = item.chunk;
+        }
+        if (item.texture != TextureLoader::kInvalid)
+            m_textureLoader.MarkUsed(item.texture, frame);
+    }
+}
+
+void DX12App::BindFrameConstants(ID3D12GraphicsCommandList* list) const
+{
+    if (m_bindless)
+        list->SetGraphicsRootConstantBufferView(m_frameConstantsParam, m_frameConstants);
+    else
+        list->SetGraphicsRootDescriptorTable(m_frameConstantsParam, m_frameConstantsTable);
+}
+
+// Everything RecordStaticDraws reads; a change re-records the bundle
+UINT64 DX12App::StaticDrawSignature(UINT firstItem, UINT lastItem) const
+{
+    UINT64 sig = BundleCache::HashValue(m_pipelineState.Get());
+    sig = BundleCache::HashValue(m_rootSignature.Get(), sig);
+    sig = BundleCache::HashValue(firstItem, sig);
+    sig = BundleCache::HashValue(lastItem, sig);
+    for (UINT i = firstItem; i < lastItem; ++i)
+    {
+        // Chunk indices are reused after RemoveLastChunk; the buffers'
+        // addresses say which geometry the bundle actually binds
+        const DrawItem& item = m_drawItems[i];
+        sig = BundleCache::HashValue(m_geometry.VertexView(item.chunk).BufferLocation, sig);
+        sig = BundleCache::HashValue(m_geometry.IndexView(item.chunk).BufferLocation, sig);
+        sig = BundleCache::HashValue(item.indexCount, sig);
+        sig = BundleCache::HashValue(item.startIndex, sig);
+        sig = BundleCache::HashValue(item.baseVertex, sig);
+        sig = BundleCache::HashValue(item.resource, sig);
+    }
+    return sig;
+}
+
+// -----------------------------------------------------------
+// Deferred release
+// -----------------------------------------------------------
+void DX12App::ReleaseDeferred(ComPtr<IUnknown> object)
+{
+    // The frame being recorded (if any) is the last that can still use it
+    m_deferredRelease.Release(std::move(object), { QueueType::Direct, m_queues.NextValue(QueueType::Direct) });
+}
+
+void DX12App::ReleaseDeferred(GpuAllocation& allocation)
+{
+    GpuAllocation released = allocation;
+    allocation = GpuAllocation{};
+    m_deferredRelease.Release([this, released]() mutable { m_gpuAllocator.Free(released); },
+        { QueueType::Direct, m_queues.NextValue(QueueType::Direct) });
 }
 
 void DX12App::WaitForGPU()
 {
-    ++m_fenceValue;
-    m_commandQueue->Signal(m_fence.Get(), m_fenceValue);
-    m_fence->SetEventOnCompletion(m_fenceValue, m_fenceEvent);
-    WaitForSingleObject(m_fenceEvent, INFINITE);
+    m_queues.WaitIdle();
 }
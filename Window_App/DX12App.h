@@ -6,19 +6,126 @@
 #include <dxgi1_6.h>
 #include <d3dcompiler.h>
 #include <DirectXMath.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "BundleCache.h"
+#include "CommandListPool.h"
+#include "CopyUploader.h"
+#include "DamageTracker.h"
+#include "DeferredReleaseQueue.h"
+#include "DescriptorAllocator.h"
+#include "EventQueue.h"
+#include "FrameGraph.h"
+#include "FramePacer.h"
+#include "FrameRing.h"
+#include "GeometryBuffer.h"
+#include "GpuAllocator.h"
+#include "LatencyTracker.h"
+#include "ParallelRecorder.h"
+#include "QueueScheduler.h"
+#include "ResidencyManager.h"
+#include "TextureLoader.h"
+#include "TextureStreamer.h"
+#include "UploadRing.h"
 
 using Microsoft::WRL::ComPtr;
 
+// Startup configuration for DX12App
+struct DX12AppSettings
+{
+    UINT frameCount = 2;                    ///< frames in flight / back buffers (2-4)
+    UINT64 uploadBytesPerFrame = 1 << 20;   ///< upload ring budget per frame in flight
+    UINT64 stagingBytes = 8 << 20;          ///< copy-queue staging ring for static geometry
+    UINT descriptorsPerFrame = 4096;        ///< shader-visible descriptor ring budget per frame in flight
+    bool bindless = false;                  ///< root signature 1.1 with one unbounded SRV/UAV table (resource binding tier 2+)
+    UINT bindlessDescriptors = 1 << 16;     ///< persistent slots addressable by bindless handle
+    bool frameLatencyWaitable = false;      ///< wait on the swap chain latency handle before recording
+    UINT maxFrameLatency = 2;               ///< latency budget in frames (1-3), waitable mode only
+    UINT recordThreads = 1;                 ///< command-list recording threads (0 = all cores)
+    bool staticBundles = false;             ///< replay static draws from cached bundles
+    bool enhancedBarriers = false;          ///< use enhanced barriers when the device supports them
+    bool renderPasses = false;              ///< bind/clear targets with BeginRenderPass instead of OMSetRenderTargets
+    bool allowTearing = false;              ///< present with sync interval 0 + tearing when supported (VRR)
+    UINT targetFps = 0;                     ///< frame pacing target (0 = no pacing)
+    bool damageTracking = false;            ///< redraw / present only invalidated rectangles (flip-sequential)
+    bool idleMode = false;                  ///< render only when dirty or animating; sleep otherwise
+    bool residency = false;                 ///< evict least-recently-used heaps to stay under the OS video memory budget
+    UINT64 streamingPoolBytes = 0;          ///< tile pool for streamed textures (0 = no streaming)
+    UINT64 streamingBytesPerFrame = 4 << 20;    ///< disk reads issued per frame for streamed textures
+    UINT64 textureLoadBytesPerFrame = 4 << 20;  ///< DDS texels staged per frame (one copy batch)
+};
+
+// Event forwarded from the UI thread to the render thread
+struct AppEvent
+{
+    enum class Type : UINT
+    {
+        Input,
+        Damage,
+    };
+
+    Type type = Type::Input;
+    UINT64 time = 0;    ///< QPC ticks when the UI thread received the message
+    RECT rect{};        ///< Damage only, client-area pixels
+};
+
 class DX12App
 {
 public:
-    DX12App(HWND hwnd, UINT width, UINT height);
+    static constexpr UINT kMaxFrameCount = 4;
+
+    DX12App(HWND hwnd, UINT width, UINT height, const DX12AppSettings& settings = {});
     ~DX12App();
 
     bool Initialize();
     void Render();
     void WaitForGPU();
 
+    // Render thread (UI thread only pumps messages and posts events)
+    bool StartRenderThread();
+    void StopRenderThread();
+    bool PostEvent(const AppEvent& ev);
+
+    // Client area resize (WM_SIZE); applied between frames
+    void OnResize(UINT width, UINT height);
+
+    // Marks a screen rectangle as changed (damage tracking mode)
+    void Invalidate(const RECT& rect);
+
+    // Idle mode: keeps rendering every frame while an animation runs
+    void SetAnimating(bool animating);
+
+    // Color multiplied into every pixel (frame constants); any thread
+    void SetSceneTint(float r, float g, float b, float a = 1.0f);
+
+    // Input-to-present latency
+    void OnInput();
+    const LatencyTracker& GetLatencyTracker() const { return m_latency; }
+
+    // Frame pacing (target fps, jitter, missed deadlines)
+    const FramePacer& GetFramePacer() const { return m_pacer; }
+
+    // GPU memory (heap utilization / fragmentation)
+    GpuAllocator::Stats GetGpuMemoryStats() const { return m_gpuAllocator.GetStats(); }
+    GeometryBuffer::Stats GetGeometryStats() const { return m_geometry.GetStats(); }
+
+    // Runtime release without a GPU flush: kept until every frame
+    // recorded so far has completed (any thread)
+    void ReleaseDeferred(ComPtr<IUnknown> object);
+    void ReleaseDeferred(GpuAllocation& allocation);
+
+    // Streamed textures (reserved resources); render thread only
+    TextureStreamer& GetTextureStreamer() { return m_streamer; }
+
+    // DDS textures loaded in the background; render thread only
+    TextureLoader& GetTextureLoader() { return m_textureLoader; }
+    TextureLoader::Stats GetTextureLoadStats() const { return m_textureLoader.GetStats(); }
+
+    // Video memory budget / paging
+    ResidencyManager::Stats GetResidencyStats() const { return m_residency.GetStats(); }
+
 private:
     // Tu
     bool CreateFactory();
@@ -26,15 +133,32 @@ private:
     bool CreateDevice();
     bool CreateCommandQueue();
     bool CreateSwapChain();
-    bool CreateRTVHeap();
+    bool CreateDescriptorHeaps();
     bool CreateRenderTargets();
-    bool CreateCommandAllocators();
-    bool CreateCommandList();
-    bool CreateFence();
+    bool Resize(UINT width, UINT height);
+    bool CreateCommandPool();
+    bool CreateUploadRing();
+    bool CreateFrameTimestamps();
+
+    void RenderThreadMain();
+    void ProcessEvents();
+    void UpdateFrameResources();
+    bool WaitForOldestFrame();
+    void AbandonFrame();
+    void Present(const std::vector<RECT>* dirtyRects);
+    bool ShouldRender();
+    bool PromoteReadyDraws();
+    void Wake();
+
+    void RecordStaticDraws(ID3D12GraphicsCommandList* list, UINT firstItem, UINT lastItem);
+    void MarkDrawsUsed(const TimelinePoint& frame);
+    void BindFrameConstants(ID3D12GraphicsCommandList* list) const;
+    UINT64 StaticDrawSignature(UINT firstItem, UINT lastItem) const;
 
     // Op``p
     bool CompileShaders();
     bool CreateRootSignature();
+    bool CreateBindlessRootSignature();
     bool CreatePipelineState();
     bool CreateTriangleResources();
 
@@ -42,24 +166,93 @@ private:
     HWND m_hWnd{};
     UINT m_width{};
     UINT m_height{};
+    DX12AppSettings m_settings;
 
     ComPtr<IDXGIFactory6> m_factory;
     ComPtr<IDXGIAdapter1> m_adapter;
     ComPtr<ID3D12Device> m_device;
-    ComPtr<ID3D12CommandQueue> m_commandQueue;
+    QueueScheduler m_queues;    ///< direct / compute / copy queues with timeline fences
     ComPtr<IDXGISwapChain3> m_swapChain;
+    HANDLE m_frameLatencyWaitable = nullptr;
+    bool m_tearing = false;     ///< allowTearing requested and DXGI_FEATURE_PRESENT_ALLOW_TEARING supported
+    FramePacer m_pacer;
+    LatencyTracker m_latency;
+
+    std::thread m_renderThread;
+    std::atomic<bool> m_renderThreadRunning{ false };
+    EventQueue<AppEvent> m_events;
+    std::atomic<UINT64> m_pendingResize{ 0 };   ///< (width << 32) | height, 0 = none; latest size wins
+    std::atomic<bool> m_pendingFullDamage{ false }; ///< a Damage event did not fit into the queue
+    DamageTracker m_damage;
 
-    ComPtr<ID3D12DescriptorHeap> m_rtvHeap;
-    UINT m_rtvDescriptorSize{ 0 };
-    ComPtr<ID3D12Resource> m_renderTargets[2];
+    // Idle mode
+    HANDLE m_wakeEvent = nullptr;           ///< signaled by anything that may need a frame
+    std::atomic<bool> m_animating{ false };
+    bool m_sceneDirty = true;               ///< render thread only
+    bool m_occluded = false;                ///< last Present returned DXGI_STATUS_OCCLUDED
 
-    ComPtr<ID3D12CommandAllocator> m_commandAllocators[2];
-    ComPtr<ID3D12GraphicsCommandList> m_commandList;
+    // Descriptors: CPU-only pools + shader-visible ring
+    DescriptorPool m_rtvPool;
+    DescriptorPool m_viewPool;                  ///< CBV/SRV/UAV staging
+    DescriptorRing m_descriptorRing;
+    Descriptor m_rtvs[kMaxFrameCount];
+    bool m_bindless = false;    ///< settings.bindless and resource binding tier 2+
+    ComPtr<ID3D12Resource> m_renderTargets[kMaxFrameCount];
 
-    ComPtr<ID3D12Fence> m_fence;
-    UINT64 m_fenceValues[2]{ 0, 0 };
-    UINT64 m_fenceValue = 0;
-    HANDLE m_fenceEvent = nullptr;
+    // Per-frame state, reused once the GPU has passed its fence value
+    struct FrameContext
+    {
+        bool timestampsPending = false; ///< GPU begin/end timestamps resolved for this slot
+    };
+
+    // Adapts the direct queue timeline to the FrameRing fence interface
+    struct FenceWaiter
+    {
+        const QueueScheduler& queues;
+        UINT64 GetCompletedValue() const { return queues.CompletedValue(QueueType::Direct); }
+        void WaitForValue(UINT64 value) const { queues.WaitCpu({ QueueType::Direct, value }); }
+    };
+
+    FrameRing<FrameContext, kMaxFrameCount> m_frames;
+
+    // Constants / dynamic vertices / staging for every frame in flight
+    UploadRing m_uploadRing;
+
+    // Per-frame constants (b1), pushed into m_uploadRing every frame
+    struct FrameConstants
+    {
+        DirectX::XMFLOAT4 tint;
+    };
+    std::atomic<UINT32> m_sceneTint{ 0xFFFFFFFFu };  ///< RGBA8, picked up by the next frame
+    D3D12_GPU_VIRTUAL_ADDRESS m_frameConstants = 0; ///< this frame's FrameConstants
+    D3D12_GPU_DESCRIPTOR_HANDLE m_frameConstantsTable{};    ///< its CBV staged in m_descriptorRing (non-bindless)
+    Descriptor m_frameCbv;                          ///< CPU view it is staged from (copied by Flush)
+    UINT m_frameConstantsParam = 0;                 ///< root parameter index of b1
+
+    // Budget-driven eviction of GpuAllocator heaps (outlives the allocator)
+    ResidencyManager m_residency;
+
+    // Placed resources in large heaps instead of one committed resource each
+    GpuAllocator m_gpuAllocator;
+
+    // Static geometry: DEFAULT heap, filled on the copy queue
+    CopyUploader m_uploader;
+
+    // GPU frame time for the pacer: two timestamps per frame slot
+    ComPtr<ID3D12QueryHeap> m_timestampHeap;
+    ComPtr<ID3D12Resource> m_timestampReadback;
+    const UINT64* m_timestampCpu = nullptr;
+    UINT64 m_timestampFrequency = 0;
+
+    // Allocator/list pairs for the render thread, recycled by fence value
+    CommandListPool m_commandPool;
+
+    ParallelRecorder m_recorder;
+    std::vector<ID3D12CommandList*> m_sceneLists;
+    std::vector<ID3D12CommandList*> m_submitLists;
+    BundleCache m_bundles;
+    FrameGraph m_frameGraph;
+    bool m_renderPasses = false;    ///< settings.renderPasses and the runtime supports ID3D12GraphicsCommandList4
 
     // Vertex / Index
     struct Vertex
@@ -68,11 +261,43 @@ private:
         DirectX::XMFLOAT4 color;
     };
 
-    ComPtr<ID3D12Resource> m_vertexBuffer;
-    ComPtr<ID3D12Resource> m_indexBuffer;
-    D3D12_VERTEX_BUFFER_VIEW m_vertexBufferView{};
-    D3D12_INDEX_BUFFER_VIEW m_indexBufferView{};
-    UINT m_indexCount = 0;
+    // Every mesh suballocated from a few shared vertex / index buffers
+    GeometryBuffer m_geometry;
+    MeshHandle m_triangle;
+
+    // Objects / allocations dropped at runtime, retired once per frame
+    DeferredReleaseQueue m_deferredRelease;
+
+    // Texture mips streamed from disk into tiles of reserved resources
+    TextureStreamer m_streamer;
+
+    // Whole DDS textures: mapped on a worker, uploaded in one batch per frame
+    TextureLoader m_textureLoader;
+
+    // Scene draws, sliced across recording tasks
+    struct DrawItem
+    {
+        UINT indexCount;
+        UINT startIndex;
+        INT baseVertex;
+        UINT32 chunk;   ///< GeometryBuffer chunk holding the vertices / indices
+        UINT32 resource;    ///< bindless handle passed in root constants (kNoResource = none)
+        UINT32 texture;     ///< TextureLoader id kept resident while drawn (TextureLoader::kInvalid = none)
+    };
+    std::vector<DrawItem> m_drawItems;
+
+    // Bindless root constants (b0) per draw
+    static constexpr UINT kDrawConstantCount = 1;
+    static constexpr UINT32 kNoResource = 0xFFFFFFFFu;
+
+    // Draws whose geometry is still being copied; moved to m_drawItems
+    // once the copy queue has passed their point
+    struct PendingDraw
+    {
+        DrawItem item;
+        TimelinePoint ready;
+    };
+    std::vector<PendingDraw> m_pendingDraws;
 
     // Shaders / PSO / RootSig
     ComPtr<ID3DBlob> m_vsBlob;
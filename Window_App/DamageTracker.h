@@ -0,0 +1,132 @@
+#pragma once
+
+#include <windows.h>
+#include <cstdint>
+#include <vector>
+
+// -----------------------------------------------------------
+// DamageTracker
+//   Collects the screen rectangles that changed and works out,
+//   per frame, which part of the back buffer has to be redrawn.
+//
+//   With a flip-sequential swap chain the back buffer handed out
+//   for a frame still holds the image presented bufferCount frames
+//   ago, so the repaint region is the union of this frame's damage
+//   and the damage of the previous (bufferCount - 1) frames.
+//   Present1 only needs this frame's damage (the change relative to
+//   the previously presented image).
+//
+//   Pure CPU; not thread-safe (owned by the render thread).
+// -----------------------------------------------------------
+class DamageTracker
+{
+public:
+    static constexpr uint32_t kMaxBuffers = 4;
+    static constexpr uint32_t kMaxRects = 16;   ///< per frame; more collapse into their bounds
+
+    /// Forgets all history; every buffer is treated as fully damaged.
+    void Reset(uint32_t bufferCount, LONG width, LONG height)
+    {
+        m_bufferCount = bufferCount < 1 ? 1 : (bufferCount > kMaxBuffers ? kMaxBuffers : bufferCount);
+        m_width = width;
+        m_height = height;
+        m_pending.assign(1, FullRect());
+        for (uint32_t i = 0; i < kMaxBuffers; ++i)
+            m_history[i].assign(1, FullRect());
+        m_frame = 0;
+    }
+
+    /// Reports a changed rectangle for the next frame (clipped to the target).
+    void Add(const RECT& rect)
+    {
+        RECT r = Clip(rect);
+        if (IsEmpty(r)) return;
+
+        // Skip rectangles that are already covered
+        for (const RECT& p : m_pending)
+            if (Contains(p, r)) return;
+
+        m_pending.push_back(r);
+        if (m_pending.size() > kMaxRects)
+        {
+            RECT bounds = Bounds(m_pending);
+            m_pending.assign(1, bounds);
+        }
+    }
+
+    void AddFull() { m_pending.assign(1, FullRect()); }
+
+    /// True if something changed since the last frame. Frames can be
+    /// skipped while this is false; the history stays valid.
+    bool NeedsRepaint() const { return !m_pending.empty(); }
+
+    /// Turns the pending damage into the current frame's damage.
+    void BeginFrame()
+    {
+        m_frame = (m_frame + 1) % m_bufferCount;
+        m_history[m_frame].swap(m_pending);
+        m_pending.clear();
+    }
+
+    /// This frame's damage, for Present1.
+    const std::vector<RECT>& FrameRects() const { return m_history[m_frame]; }
+
+    /// Bounds of everything the current back buffer is missing (empty = nothing to draw).
+    RECT RepaintBounds() const
+    {
+        RECT bounds = { 0, 0, 0, 0 };
+        for (uint32_t i = 0; i < m_bufferCount; ++i)
+            for (const RECT& r : m_history[i])
+                bounds = Union(bounds, r);
+        return bounds;
+    }
+
+    static bool IsEmpty(const RECT& r) { return r.right <= r.left || r.bottom <= r.top; }
+
+private:
+    RECT FullRect() const { return { 0, 0, m_width, m_height }; }
+
+    RECT Clip(const RECT& r) const
+    {
+        RECT c;
+        c.left = r.left < 0 ? 0 : r.left;
+        c.top = r.top < 0 ? 0 : r.top;
+        c.right = r.right > m_width ? m_width : r.right;
+        c.bottom = r.bottom > m_height ? m_height : r.bottom;
+        return c;
+    }
+
+    static bool Contains(const RECT& outer, const RECT& inner)
+    {
+        return outer.left <= inner.left && outer.top <= inner.top &&
+            outer.right >= inner.right && outer.bottom >= inner.bottom;
+    }
+
+    static RECT Union(const RECT& a, const RECT& b)
+    {
+        if (IsEmpty(a)) return b;
+        if (IsEmpty(b)) return a;
+        RECT u;
+        u.left = a.left < b.left ? a.left : b.left;
+        u.top = a.top < b.top ? a.top : b.top;
+        u.right = a.right > b.right ? a.right : b.right;
+        u.bottom = a.bottom > b.bottom ? a.bottom : b.bottom;
+        return u;
+    }
+
+    static RECT Bounds(const std::vector<RECT>& rects)
+    {
+        RECT bounds = { 0, 0, 0, 0 };
+        for (const RECT& r : rects)
+            bounds = Union(bounds, r);
+        return bounds;
+    }
+
+private:
+    uint32_t m_bufferCount = 1;
+    LONG m_width = 0;
+    LONG m_height = 0;
+    std::vector<RECT> m_pending;
+    std::vector<RECT> m_history[kMaxBuffers];   ///< damage per recent frame
+    uint32_t m_frame = 0;                       ///< slot of the current frame in m_history
+};
@@ -0,0 +1,305 @@
+#include "DdsFile.h"
+#include "d3dx12.h"
+
+namespace
+{
+    const UINT32 kDdsMagic = 0x20534444;    // "DDS "
+
+    // DDS_PIXELFORMAT flags
+    const UINT32 kPixelFourCC = 0x4;
+    const UINT32 kPixelRgb = 0x40;
+    const UINT32 kPixelLuminance = 0x20000;
+    const UINT32 kPixelAlpha = 0x2;
+
+    // DDS_HEADER caps2
+    const UINT32 kCaps2Cubemap = 0x200;
+    const UINT32 kCaps2Volume = 0x200000;
+
+    // DDS_HEADER_DXT10 misc flag
+    const UINT32 kMiscTextureCube = 0x4;
+
+    struct DdsPixelFormat
+    {
+        UINT32 size;
+        UINT32 flags;
+        UINT32 fourCC;
+        UINT32 rgbBitCount;
+        UINT32 rMask, gMask, bMask, aMask;
+    };
+
+    struct DdsHeader
+    {
+        UINT32 size;
+        UINT32 flags;
+        UINT32 height;
+        UINT32 width;
+        UINT32 pitchOrLinearSize;
+        UINT32 depth;
+        UINT32 mipMapCount;
+        UINT32 reserved1[11];
+        DdsPixelFormat format;
+        UINT32 caps;
+        UINT32 caps2;
+        UINT32 caps3;
+        UINT32 caps4;
+        UINT32 reserved2;
+    };
+
+    struct DdsHeaderDx10
+    {
+        UINT32 dxgiFormat;
+        UINT32 resourceDimension;   // D3D10_RESOURCE_DIMENSION: 2 = 1D, 3 = 2D, 4 = 3D
+        UINT32 miscFlag;
+        UINT32 arraySize;
+        UINT32 miscFlags2;
+    };
+
+    constexpr UINT32 FourCC(char a, char b, char c, char d)
+    {
+        return static_cast<UINT32>(a) | (static_cast<UINT32>(b) << 8) |
+            (static_cast<UINT32>(c) << 16) | (static_cast<UINT32>(d) << 24);
+    }
+
+    // Bytes per 4x4 block for BC formats, 0 otherwise
+    UINT BlockBytes(DXGI_FORMAT format)
+    {
+        switch (format)
+        {
+        case DXGI_FORMAT_BC1_UNORM: case DXGI_FORMAT_BC1_UNORM_SRGB:
+        case DXGI_FORMAT_BC4_UNORM: case DXGI_FORMAT_BC4_SNORM:
+            return 8;
+        case DXGI_FORMAT_BC2_UNORM: case DXGI_FORMAT_BC2_UNORM_SRGB:
+        case DXGI_FORMAT_BC3_UNORM: case DXGI_FORMAT_BC3_UNORM_SRGB:
+        case DXGI_FORMAT_BC5_UNORM: case DXGI_FORMAT_BC5_SNORM:
+        case DXGI_FORMAT_BC6H_UF16: case DXGI_FORMAT_BC6H_SF16:
+        case DXGI_FORMAT_BC7_UNORM: case DXGI_FORMAT_BC7_UNORM_SRGB:
+            return 16;
+        default:
+            return 0;
+        }
+    }
+
+    // Bits per pixel for uncompressed formats, 0 = unsupported
+    UINT BitsPerPixel(DXGI_FORMAT format)
+    {
+        switch (format)
+        {
+        case DXGI_FORMAT_R32G32B32A32_FLOAT: case DXGI_FORMAT_R32G32B32A32_UINT:
+            return 128;
+        case DXGI_FORMAT_R16G16B16A16_FLOAT: case DXGI_FORMAT_R16G16B16A16_UNORM:
+        case DXGI_FORMAT_R32G32_FLOAT:
+            return 64;
+        case DXGI_FORMAT_R8G8B8A8_UNORM: case DXGI_FORMAT_R8G8B8A8_UNORM_SRGB:
+        case DXGI_FORMAT_B8G8R8A8_UNORM: case DXGI_FORMAT_B8G8R8A8_UNORM_SRGB:
+        case DXGI_FORMAT_B8G8R8X8_UNORM: case DXGI_FORMAT_R10G10B10A2_UNORM:
+        case DXGI_FORMAT_R11G11B10_FLOAT: case DXGI_FORMAT_R16G16_FLOAT:
+        case DXGI_FORMAT_R16G16_UNORM: case DXGI_FORMAT_R32_FLOAT:
+            return 32;
+        case DXGI_FORMAT_R8G8_UNORM: case DXGI_FORMAT_R16_FLOAT:
+        case DXGI_FORMAT_R16_UNORM: case DXGI_FORMAT_B5G6R5_UNORM:
+            return 16;
+        case DXGI_FORMAT_R8_UNORM: case DXGI_FORMAT_A8_UNORM:
+            return 8;
+        default:
+            return 0;
+        }
+    }
+
+    bool MaskIs(const DdsPixelFormat& pf, UINT32 r, UINT32 g, UINT32 b, UINT32 a)
+    {
+        return pf.rMask == r && pf.gMask == g && pf.bMask == b && pf.aMask == a;
+    }
+
+    // Legacy (pre-DX10) pixel formats
+    DXGI_FORMAT LegacyFormat(const DdsPixelFormat& pf)
+    {
+        if (pf.flags & kPixelFourCC)
+        {
+            switch (pf.fourCC)
+            {
+            case FourCC('D', 'X', 'T', '1'): return DXGI_FORMAT_BC1_UNORM;
+            case FourCC('D', 'X', 'T', '2'):
+            case FourCC('D', 'X', 'T', '3'): return DXGI_FORMAT_BC2_UNORM;
+            case FourCC('D', 'X', 'T', '4'):
+            case FourCC('D', 'X', 'T', '5'): return DXGI_FORMAT_BC3_UNORM;
+            case FourCC('A', 'T', 'I', '1'):
+            case FourCC('B', 'C', '4', 'U'): return DXGI_FORMAT_BC4_UNORM;
+            case FourCC('B', 'C', '4', 'S'): return DXGI_FORMAT_BC4_SNORM;
+            case FourCC('A', 'T', 'I', '2'):
+            case FourCC('B', 'C', '5', 'U'): return DXGI_FORMAT_BC5_UNORM;
+            case FourCC('B', 'C', '5', 'S'): return DXGI_FORMAT_BC5_SNORM;
+            case 113: return DXGI_FORMAT_R16G16B16A16_FLOAT;   // D3DFMT_A16B16G16R16F
+            case 116: return DXGI_FORMAT_R32G32B32A32_FLOAT;   // D3DFMT_A32B32G32R32F
+            default: return DXGI_FORMAT_UNKNOWN;
+            }
+        }
+
+        if (pf.flags & kPixelRgb)
+        {
+            if (pf.rgbBitCount == 32)
+            {
+                if (MaskIs(pf, 0x000000FF, 0x0000FF00, 0x00FF0000, 0xFF000000)) return DXGI_FORMAT_R8G8B8A8_UNORM;
+                if (MaskIs(pf, 0x00FF0000, 0x0000FF00, 0x000000FF, 0xFF000000)) return DXGI_FORMAT_B8G8R8A8_UNORM;
+                if (MaskIs(pf, 0x00FF0000, 0x0000FF00, 0x000000FF, 0x00000000)) return DXGI_FORMAT_B8G8R8X8_UNORM;
+                if (MaskIs(pf, 0x0000FFFF, 0xFFFF0000, 0x00000000, 0x00000000)) return DXGI_FORMAT_R16G16_UNORM;
+            }
+            if (pf.rgbBitCount == 16 && MaskIs(pf, 0xF800, 0x07E0, 0x001F, 0x0000))
+                return DXGI_FORMAT_B5G6R5_UNORM;
+        }
+
+        if ((pf.flags & kPixelLuminance) && pf.rgbBitCount == 8) return DXGI_FORMAT_R8_UNORM;
+        if ((pf.flags & kPixelAlpha) && pf.rgbBitCount == 8) return DXGI_FORMAT_A8_UNORM;
+        return DXGI_FORMAT_UNKNOWN;
+    }
+
+    void SurfacePitch(DXGI_FORMAT format, UINT width, UINT height, UINT64& rowPitch, UINT& rowCount)
+    {
+        if (const UINT block = BlockBytes(format))
+        {
+            rowPitch = static_cast<UINT64>(width > 0 ? (width + 3) / 4 : 0) * block;
+            rowCount = height > 0 ? (height + 3) / 4 : 0;
+            if (rowPitch == 0) rowPitch = block;
+            if (rowCount == 0) rowCount = 1;
+        }
+        else
+        {
+            rowPitch = (static_cast<UINT64>(width) * BitsPerPixel(format) + 7) / 8;
+            rowCount = height;
+        }
+    }
+}
+
+// -----------------------------------------------------------
+// DdsImage
+// -----------------------------------------------------------
+D3D12_RESOURCE_DESC DdsImage::ResourceDesc() const
+{
+    switch (dimension)
+    {
+    case D3D12_RESOURCE_DIMENSION_TEXTURE1D:
+        return CD3DX12_RESOURCE_DESC::Tex1D(format, width, static_cast<UINT16>(depthOrArraySize), mipLevels);
+    case D3D12_RESOURCE_DIMENSION_TEXTURE3D:
+        return CD3DX12_RESOURCE_DESC::Tex3D(format, width, height, static_cast<UINT16>(depthOrArraySize), mipLevels);
+    default:
+        return CD3DX12_RESOURCE_DESC::Tex2D(format, width, height, static_cast<UINT16>(depthOrArraySize), mipLevels);
+    }
+}
+
+UINT64 DdsImage::DataBytes() const
+{
+    UINT64 total = 0;
+    for (UINT i = 0; i < subresources.size(); ++i)
+    {
+        UINT depth = 1;
+        if (dimension == D3D12_RESOURCE_DIMENSION_TEXTURE3D)
+        {
+            depth = depthOrArraySize >> (i % mipLevels);
+            if (depth == 0) depth = 1;
+        }
+        total += static_cast<UINT64>(subresources[i].SlicePitch) * depth;
+    }
+    return total;
+}
+
+// -----------------------------------------------------------
+// Parsing
+// -----------------------------------------------------------
+bool ParseDds(const void* data, size_t size, DdsImage& out)
+{
+    const UINT8* bytes = static_cast<const UINT8*>(data);
+    if (size < sizeof(UINT32) + sizeof(DdsHeader)) return false;
+    if (*reinterpret_cast<const UINT32*>(bytes) != kDdsMagic) return false;
+
+    const DdsHeader& header = *reinterpret_cast<const DdsHeader*>(bytes + sizeof(UINT32));
+    if (header.size != sizeof(DdsHeader) || header.format.size != sizeof(DdsPixelFormat)) return false;
+
+    size_t offset = sizeof(UINT32) + sizeof(DdsHeader);
+    out = DdsImage{};
+    out.width = header.width;
+    out.height = header.height > 0 ? header.height : 1;
+    out.mipLevels = static_cast<UINT16>(header.mipMapCount > 0 ? header.mipMapCount : 1);
+
+    UINT arraySize = 1;
+    if ((header.format.flags & kPixelFourCC) && header.format.fourCC == FourCC('D', 'X', '1', '0'))
+    {
+        if (size < offset + sizeof(DdsHeaderDx10)) return false;
+        const DdsHeaderDx10& dx10 = *reinterpret_cast<const DdsHeaderDx10*>(bytes + offset);
+        offset += sizeof(DdsHeaderDx10);
+
+        out.format = static_cast<DXGI_FORMAT>(dx10.dxgiFormat);
+        arraySize = dx10.arraySize > 0 ? dx10.arraySize : 1;
+        switch (dx10.resourceDimension)
+        {
+        case 2:
+            out.dimension = D3D12_RESOURCE_DIMENSION_TEXTURE1D;
+            out.height = 1;
+            break;
+        case 3:
+            out.dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
+            if (dx10.miscFlag & kMiscTextureCube)
+            {
+                out.cubemap = true;
+                arraySize *= 6;
+            }
+            break;
+        case 4:
+            out.dimension = D3D12_RESOURCE_DIMENSION_TEXTURE3D;
+            break;
+        default:
+            return false;
+        }
+        out.depthOrArraySize = out.dimension == D3D12_RESOURCE_DIMENSION_TEXTURE3D ? header.depth : arraySize;
+    }
+    else
+    {
+        out.format = LegacyFormat(header.format);
+        if (header.caps2 & kCaps2Volume)
+        {
+            out.dimension = D3D12_RESOURCE_DIMENSION_TEXTURE3D;
+            out.depthOrArraySize = header.depth;
+        }
+        else if (header.caps2 & kCaps2Cubemap)
+        {
+            // Partial cube maps are not supported
+            if ((header.caps2 & 0xFC00) != 0xFC00) return false;
+            out.cubemap = true;
+            arraySize = 6;
+            out.depthOrArraySize = 6;
+        }
+    }
+
+    if (out.format == DXGI_FORMAT_UNKNOWN || (BlockBytes(out.format) == 0 && BitsPerPixel(out.format) == 0))
+        return false;
+    if (out.width == 0 || out.depthOrArraySize == 0) return false;
+
+    // DDS order matches D3D12 subresource order: every mip of slice 0, then slice 1, ...
+    const bool volume = out.dimension == D3D12_RESOURCE_DIMENSION_TEXTURE3D;
+    const UINT slices = volume ? 1 : arraySize;
+    for (UINT slice = 0; slice < slices; ++slice)
+    {
+        UINT w = out.width;
+        UINT h = out.height;
+        UINT d = volume ? out.depthOrArraySize : 1;
+        for (UINT mip = 0; mip < out.mipLevels; ++mip)
+        {
+            UINT64 rowPitch = 0;
+            UINT rowCount = 0;
+            SurfacePitch(out.format, w, h, rowPitch, rowCount);
+            const UINT64 slicePitch = rowPitch * rowCount;
+            const UINT64 bytesNeeded = slicePitch * d;
+            if (offset + bytesNeeded > size) return false;
+
+            D3D12_SUBRESOURCE_DATA sub{};
+            sub.pData = bytes + offset;
+            sub.RowPitch = static_cast<LONG_PTR>(rowPitch);
+            sub.SlicePitch = static_cast<LONG_PTR>(slicePitch);
+            out.subresources.push_back(sub);
+            offset += static_cast<size_t>(bytesNeeded);
+
+            w = w > 1 ? w / 2 : 1;
+            h = h > 1 ? h / 2 : 1;
+            d = d > 1 ? d / 2 : 1;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <windows.h>
+#include <d3d12.h>
+#include <cstddef>
+#include <vector>
+
+// Texture described by a DDS file; subresources point into the file bytes
+struct DdsImage
+{
+    D3D12_RESOURCE_DIMENSION dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
+    DXGI_FORMAT format = DXGI_FORMAT_UNKNOWN;
+    UINT width = 0;
+    UINT height = 0;
+    UINT depthOrArraySize = 1;      ///< depth (3D) or array slices (6 per cube)
+    UINT16 mipLevels = 1;
+    bool cubemap = false;
+    std::vector<D3D12_SUBRESOURCE_DATA> subresources;   ///< D3D12 order: slice-major, then mip
+
+    D3D12_RESOURCE_DESC ResourceDesc() const;
+    UINT64 DataBytes() const;       ///< sum of the subresources' slice pitches x depth
+};
+
+// -----------------------------------------------------------
+// DDS parsing
+//   Reads the DDS header (legacy or DX10 extension) of a file that
+//   is already in memory (e.g. a mapped view) and computes every
+//   subresource's pitch and location. Nothing is copied.
+//
+//   Supported: 1D / 2D / 3D textures, arrays and cube maps in the
+//   common uncompressed and BC formats. Pure CPU.
+// -----------------------------------------------------------
+bool ParseDds(const void* data, size_t size, DdsImage& out);
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <windows.h>
+#include <wrl.h>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+#include "QueueScheduler.h"
+
+using Microsoft::WRL::ComPtr;
+
+// -----------------------------------------------------------
+// DeferredReleaseQueue
+//   Keeps objects (or runs cleanup, e.g. returning a range to an
+//   allocator) until the timeline point of their last GPU use has
+//   completed, so anything can be dropped mid-frame without a
+//   GPU flush. One FIFO per queue timeline: points on a timeline
+//   only grow, so Retire() stops at the first pending entry.
+//
+//   Release() may be called from any thread; Retire() runs once
+//   per frame on the render thread. Callbacks run outside the lock.
+// -----------------------------------------------------------
+class DeferredReleaseQueue
+{
+public:
+    using Callback = std::function<void()>;
+
+    DeferredReleaseQueue() = default;
+    ~DeferredReleaseQueue() { Flush(); }
+
+    DeferredReleaseQueue(const DeferredReleaseQueue&) = delete;
+    DeferredReleaseQueue& operator=(const DeferredReleaseQueue&) = delete;
+
+    void Release(ComPtr<IUnknown> object, const TimelinePoint& lastUse)
+    {
+        Push({ std::move(object), Callback(), lastUse.value }, lastUse.queue);
+    }
+
+    void Release(Callback callback, const TimelinePoint& lastUse)
+    {
+        Push({ nullptr, std::move(callback), lastUse.value }, lastUse.queue);
+    }
+
+    /// Releases every entry whose point the GPU has passed.
+    void Retire(const QueueScheduler& queues)
+    {
+        std::vector<Entry> done;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            for (UINT q = 0; q < QueueScheduler::kQueueCount; ++q)
+            {
+                std::deque<Entry>& pending = m_pending[q];
+                if (pending.empty()) continue;
+
+                const UINT64 completed = queues.CompletedValue(static_cast<QueueType>(q));
+                while (!pending.empty() && pending.front().fenceValue <= completed)
+                {
+                    done.push_back(std::move(pending.front()));
+                    pending.pop_front();
+                }
+            }
+        }
+        Run(done);
+    }
+
+    /// Releases everything; only after the GPU is idle (shutdown).
+    void Flush()
+    {
+        std::vector<Entry> done;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            for (std::deque<Entry>& pending : m_pending)
+            {
+                for (Entry& e : pending) done.push_back(std::move(e));
+                pending.clear();
+            }
+        }
+        Run(done);
+    }
+
+    size_t PendingCount() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        size_t count = 0;
+        for (const std::deque<Entry>& pending : m_pending) count += pending.size();
+        return count;
+    }
+
+private:
+    struct Entry
+    {
+        ComPtr<IUnknown> object;
+        Callback callback;
+        UINT64 fenceValue;
+    };
+
+    void Push(Entry entry, QueueType queue)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        std::deque<Entry>& pending = m_pending[static_cast<UINT>(queue)];
+
+        // Keep each FIFO ordered even if a caller names an older point
+        if (!pending.empty() && entry.fenceValue < pending.back().fenceValue)
+            entry.fenceValue = pending.back().fenceValue;
+        pending.push_back(std::move(entry));
+    }
+
+    static void Run(std::vector<Entry>& done)
+    {
+        for (Entry& e : done)
+            if (e.callback) e.callback();
+        done.clear();   // drops the object references
+    }
+
+private:
+    mutable std::mutex m_mutex;
+    std::deque<Entry> m_pending[QueueScheduler::kQueueCount];
+};
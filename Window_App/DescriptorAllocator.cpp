@@ -0,0 +1,146 @@
+#include "DescriptorAllocator.h"
+
+// -----------------------------------------------------------
+// DescriptorPool
+// -----------------------------------------------------------
+bool DescriptorPool::Initialize(ID3D12Device* device, D3D12_DESCRIPTOR_HEAP_TYPE type, UINT pageSize)
+{
+    m_device = device;
+    m_type = type;
+    m_descriptorSize = device->GetDescriptorHandleIncrementSize(type);
+    m_slots.Reset(pageSize);
+    return AddPage();
+}
+
+void DescriptorPool::Shutdown()
+{
+    m_pages.clear();
+    m_slots.Reset(m_slots.PageSize());
+}
+
+bool DescriptorPool::AddPage()
+{
+    D3D12_DESCRIPTOR_HEAP_DESC desc{};
+    desc.NumDescriptors = m_slots.PageSize();
+    desc.Type = m_type;
+    desc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_NONE;
+
+    ComPtr<ID3D12DescriptorHeap> heap;
+    if (FAILED(m_device->CreateDescriptorHeap(&desc, IID_PPV_ARGS(&heap))))
+        return false;
+
+    m_pages.push_back(heap);
+    m_slots.AddPage();
+    return true;
+}
+
+Descriptor DescriptorPool::Allocate()
+{
+    UINT32 slot = m_slots.Allocate();
+    if (slot == DescriptorFreeList::kInvalid)
+    {
+        if (!AddPage()) return {};
+        slot = m_slots.Allocate();
+    }
+
+    Descriptor d;
+    d.slot = slot;
+    d.cpu = m_pages[m_slots.PageOf(slot)]->GetCPUDescriptorHandleForHeapStart();
+    d.cpu.ptr += static_cast<SIZE_T>(m_slots.IndexInPage(slot)) * m_descriptorSize;
+    return d;
+}
+
+void DescriptorPool::Free(Descriptor& descriptor)
+{
+    if (!descriptor) return;
+    m_slots.Free(descriptor.slot);
+    descriptor = Descriptor{};
+}
+
+// -----------------------------------------------------------
+// DescriptorRing
+// -----------------------------------------------------------
+bool DescriptorRing::Initialize(ID3D12Device* device, UINT capacity, UINT reserved)
+{
+    m_device = device;
+    m_reserved = reserved;
+
+    D3D12_DESCRIPTOR_HEAP_DESC desc{};
+    desc.NumDescriptors = capacity + reserved;
+    desc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV;
+    desc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE;
+
+    if (FAILED(device->CreateDescriptorHeap(&desc, IID_PPV_ARGS(&m_heap))))
+        return false;
+
+    m_descriptorSize = device->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+    m_cpuStart = m_heap->GetCPUDescriptorHandleForHeapStart();
+    m_gpuStart = m_heap->GetGPUDescriptorHandleForHeapStart();
+    m_ring.Reset(capacity);
+
+    m_persistent.Reset(reserved);
+    if (reserved > 0) m_persistent.AddPage();
+    return true;
+}
+
+void DescriptorRing::Shutdown()
+{
+    m_destStarts.clear();
+    m_destSizes.clear();
+    m_sources.clear();
+    m_heap.Reset();
+    m_ring.Reset(0);
+}
+
+DescriptorRing::Table DescriptorRing::Reserved(UINT index) const
+{
+    Table t;
+    t.offset = index;
+    t.cpu.ptr = m_cpuStart.ptr + static_cast<SIZE_T>(index) * m_descriptorSize;
+    t.gpu.ptr = m_gpuStart.ptr + static_cast<UINT64>(index) * m_descriptorSize;
+    return t;
+}
+
+UINT32 DescriptorRing::AddPersistent(D3D12_CPU_DESCRIPTOR_HANDLE source)
+{
+    const UINT32 index = m_persistent.Allocate();
+    if (index == DescriptorFreeList::kInvalid) return index;
+
+    m_device->CopyDescriptorsSimple(1, Reserved(index).cpu, source, D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+    return index;
+}
+
+void DescriptorRing::RemovePersistent(UINT32 index)
+{
+    m_persistent.Free(index);
+}
+
+DescriptorRing::Table DescriptorRing::Stage(const D3D12_CPU_DESCRIPTOR_HANDLE* sources, UINT count)
+{
+    if (count == 0) return {};
+
+    const UINT64 offset = m_ring.Allocate(count);
+    if (offset == RingAllocator::kInvalidOffset) return {};
+
+    const Table t = Reserved(m_reserved + static_cast<UINT>(offset));
+    m_destStarts.push_back(t.cpu);
+    m_destSizes.push_back(count);
+    m_sources.insert(m_sources.end(), sources, sources + count);
+    return t;
+}
+
+void DescriptorRing::Flush()
+{
+    if (m_destStarts.empty()) return;
+
+    // Sources are single descriptors scattered across pool pages, so
+    // each one is its own source range (size 1 = nullptr sizes)
+    m_device->CopyDescriptors(static_cast<UINT>(m_destStarts.size()), m_destStarts.data(), m_destSizes.data(),
+        static_cast<UINT>(m_sources.size()), m_sources.data(), nullptr,
+        D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+
+    m_copied += m_sources.size();
+    m_destStarts.clear();
+    m_destSizes.clear();
+    m_sources.clear();
+}
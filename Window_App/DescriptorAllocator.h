@@ -0,0 +1,131 @@
+#pragma once
+
+#include <windows.h>
+#include <wrl.h>
+#include <d3d12.h>
+#include <vector>
+
+#include "DescriptorFreeList.h"
+#include "RingAllocator.h"
+
+using Microsoft::WRL::ComPtr;
+
+// Long-lived CPU descriptor out of a DescriptorPool
+struct Descriptor
+{
+    D3D12_CPU_DESCRIPTOR_HANDLE cpu{};
+    UINT32 slot = DescriptorFreeList::kInvalid;
+
+    explicit operator bool() const { return slot != DescriptorFreeList::kInvalid; }
+};
+
+// -----------------------------------------------------------
+// DescriptorPool
+//   CPU-only (non shader-visible) descriptors of one heap type.
+//   Backed by heaps of `pageSize` descriptors each; a new heap is
+//   created when every slot is in use, and freed slots are reused
+//   first. Views are written here once and copied to the
+//   shader-visible DescriptorRing when a frame needs them.
+//   Not thread-safe.
+// -----------------------------------------------------------
+class DescriptorPool
+{
+public:
+    DescriptorPool() = default;
+
+    DescriptorPool(const DescriptorPool&) = delete;
+    DescriptorPool& operator=(const DescriptorPool&) = delete;
+
+    bool Initialize(ID3D12Device* device, D3D12_DESCRIPTOR_HEAP_TYPE type, UINT pageSize = 256);
+    void Shutdown();
+
+    Descriptor Allocate();
+    void Free(Descriptor& descriptor);
+
+    D3D12_DESCRIPTOR_HEAP_TYPE Type() const { return m_type; }
+    UINT DescriptorSize() const { return m_descriptorSize; }
+    const DescriptorFreeList& Slots() const { return m_slots; }
+
+private:
+    bool AddPage();
+
+private:
+    ID3D12Device* m_device = nullptr;
+    D3D12_DESCRIPTOR_HEAP_TYPE m_type = D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV;
+    UINT m_descriptorSize = 0;
+    std::vector<ComPtr<ID3D12DescriptorHeap>> m_pages;
+    DescriptorFreeList m_slots;
+};
+
+// -----------------------------------------------------------
+// DescriptorRing
+//   One shader-visible CBV/SRV/UAV heap shared by all frames in
+//   flight. Stage() reserves a contiguous table and queues a copy
+//   of CPU descriptors into it; Flush() issues every queued copy
+//   with a single CopyDescriptors call, and must run before the
+//   lists that use the tables are submitted. Tables are sealed
+//   with the frame's fence value and reused once the GPU is past
+//   it, like UploadRing.
+//
+//   The first `reserved` descriptors are persistent: AddPersistent()
+//   copies a view there and returns its index, which shaders use as
+//   a bindless handle into an unbounded table at the heap start.
+//   Render thread only.
+// -----------------------------------------------------------
+class DescriptorRing
+{
+public:
+    struct Table
+    {
+        D3D12_CPU_DESCRIPTOR_HANDLE cpu{};
+        D3D12_GPU_DESCRIPTOR_HANDLE gpu{};      ///< 0 = ring full
+        UINT offset = 0;                        ///< index into the heap
+
+        explicit operator bool() const { return gpu.ptr != 0; }
+    };
+
+    DescriptorRing() = default;
+
+    DescriptorRing(const DescriptorRing&) = delete;
+    DescriptorRing& operator=(const DescriptorRing&) = delete;
+
+    bool Initialize(ID3D12Device* device, UINT capacity, UINT reserved = 0);
+    void Shutdown();
+
+    /// Reserves `count` consecutive descriptors and queues copies from `sources`.
+    Table Stage(const D3D12_CPU_DESCRIPTOR_HANDLE* sources, UINT count);
+
+    /// Descriptors [0, reserved) are never handed out by the ring (persistent entries).
+    Table Reserved(UINT index) const;
+
+    /// Copies `source` into a free persistent slot; returns its index or DescriptorFreeList::kInvalid.
+    UINT32 AddPersistent(D3D12_CPU_DESCRIPTOR_HANDLE source);
+    /// The caller makes sure the GPU no longer reads the slot.
+    void RemovePersistent(UINT32 index);
+
+    void Flush();
+    void Seal(UINT64 fenceValue) { m_ring.Seal(fenceValue); }
+    void Reclaim(UINT64 completedFence) { m_ring.Reclaim(completedFence); }
+
+    ID3D12DescriptorHeap* Heap() const { return m_heap.Get(); }
+    UINT DescriptorSize() const { return m_descriptorSize; }
+    const RingAllocator& Allocator() const { return m_ring; }
+    const DescriptorFreeList& PersistentSlots() const { return m_persistent; }
+    UINT64 CopiedDescriptors() const { return m_copied; }
+
+private:
+    ID3D12Device* m_device = nullptr;
+    ComPtr<ID3D12DescriptorHeap> m_heap;
+    D3D12_CPU_DESCRIPTOR_HANDLE m_cpuStart{};
+    D3D12_GPU_DESCRIPTOR_HANDLE m_gpuStart{};
+    UINT m_descriptorSize = 0;
+    UINT m_reserved = 0;
+    RingAllocator m_ring;       ///< in descriptors, after the reserved range
+    DescriptorFreeList m_persistent;    ///< slots of the reserved range (one page)
+
+    // Queued copies: one destination range per Stage(), one source range per descriptor
+    std::vector<D3D12_CPU_DESCRIPTOR_HANDLE> m_destStarts;
+    std::vector<UINT> m_destSizes;
+    std::vector<D3D12_CPU_DESCRIPTOR_HANDLE> m_sources;
+    UINT64 m_copied = 0;
+};
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// -----------------------------------------------------------
+// DescriptorFreeList
+//   Slot bookkeeping for a descriptor pool that grows in pages.
+//   Slot i lives in page i / pageSize at index i % pageSize. Freed
+//   slots go on a LIFO free list and are handed out again before
+//   a new page is requested, so the pool only grows when every
+//   existing slot is in use.
+//
+//   Indices only; no device needed, so it can be tested headlessly.
+//   Not thread-safe.
+// -----------------------------------------------------------
+class DescriptorFreeList
+{
+public:
+    static constexpr uint32_t kInvalid = 0xFFFFFFFFu;
+
+    explicit DescriptorFreeList(uint32_t pageSize = 256) { Reset(pageSize); }
+
+    void Reset(uint32_t pageSize)
+    {
+        m_pageSize = pageSize;
+        m_pageCount = 0;
+        m_free.clear();
+        m_allocated.clear();
+    }
+
+    /// Returns a free slot, or kInvalid if a page has to be added first.
+    uint32_t Allocate()
+    {
+        if (m_free.empty()) return kInvalid;
+        const uint32_t slot = m_free.back();
+        m_free.pop_back();
+        m_allocated[slot] = true;
+        return slot;
+    }
+
+    /// Makes the slots of one more page available; returns the page index.
+    uint32_t AddPage()
+    {
+        const uint32_t page = m_pageCount++;
+        const uint32_t first = page * m_pageSize;
+        m_allocated.resize(static_cast<size_t>(m_pageCount) * m_pageSize, false);
+
+        // Reverse order: the lowest slot of the page is handed out first
+        for (uint32_t i = m_pageSize; i-- > 0;)
+            m_free.push_back(first + i);
+        return page;
+    }
+
+    /// Returns false for slots that are not currently allocated.
+    bool Free(uint32_t slot)
+    {
+        if (slot >= m_allocated.size() || !m_allocated[slot]) return false;
+        m_allocated[slot] = false;
+        m_free.push_back(slot);
+        return true;
+    }
+
+    uint32_t PageOf(uint32_t slot) const { return slot / m_pageSize; }
+    uint32_t IndexInPage(uint32_t slot) const { return slot % m_pageSize; }
+
+    uint32_t PageSize() const { return m_pageSize; }
+    uint32_t PageCount() const { return m_pageCount; }
+    uint32_t Capacity() const { return m_pageCount * m_pageSize; }
+    uint32_t FreeCount() const { return static_cast<uint32_t>(m_free.size()); }
+    uint32_t UsedCount() const { return Capacity() - FreeCount(); }
+
+private:
+    uint32_t m_pageSize = 0;
+    uint32_t m_pageCount = 0;
+    std::vector<uint32_t> m_free;
+    std::vector<bool> m_allocated;
+};
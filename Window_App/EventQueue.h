@@ -0,0 +1,54 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+// -----------------------------------------------------------
+// EventQueue
+//   Lock-free single-producer / single-consumer ring buffer.
+//   The UI thread pushes, the render thread pops; neither side
+//   ever blocks. Capacity must be a power of two.
+// -----------------------------------------------------------
+template <typename T, uint32_t Capacity = 256>
+class EventQueue
+{
+    static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+    /// Producer side. Returns false (and drops the event) when full.
+    bool Push(const T& item)
+    {
+        const uint32_t tail = m_tail.load(std::memory_order_relaxed);
+        const uint32_t head = m_head.load(std::memory_order_acquire);
+        if (tail - head == Capacity)
+            return false;
+
+        m_items[tail & (Capacity - 1)] = item;
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /// Consumer side. Returns false when empty.
+    bool Pop(T& out)
+    {
+        const uint32_t head = m_head.load(std::memory_order_relaxed);
+        const uint32_t tail = m_tail.load(std::memory_order_acquire);
+        if (head == tail)
+            return false;
+
+        out = m_items[head & (Capacity - 1)];
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool Empty() const
+    {
+        return m_head.load(std::memory_order_acquire) == m_tail.load(std::memory_order_acquire);
+    }
+
+private:
+    std::array<T, Capacity> m_items{};
+    alignas(64) std::atomic<uint32_t> m_head{ 0 };
+    alignas(64) std::atomic<uint32_t> m_tail{ 0 };
+};
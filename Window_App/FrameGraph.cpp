@@ -0,0 +1,667 @@
+#include "FrameGraph.h"
+#include <algorithm>
+#include "d3dx12.h"
+
+namespace
+{
+    const D3D12_RESOURCE_STATES kWriteStates =
+        D3D12_RESOURCE_STATE_RENDER_TARGET |
+        D3D12_RESOURCE_STATE_UNORDERED_ACCESS |
+        D3D12_RESOURCE_STATE_DEPTH_WRITE |
+        D3D12_RESOURCE_STATE_STREAM_OUT |
+        D3D12_RESOURCE_STATE_COPY_DEST |
+        D3D12_RESOURCE_STATE_RESOLVE_DEST;
+
+    uint64_t AlignUp(uint64_t value, uint64_t alignment)
+    {
+        return (value + alignment - 1) & ~(alignment - 1);
+    }
+
+    // Legacy resource state -> enhanced barrier sync / access / layout
+    struct EnhancedState
+    {
+        D3D12_BARRIER_SYNC sync = D3D12_BARRIER_SYNC_NONE;
+        D3D12_BARRIER_ACCESS access = D3D12_BARRIER_ACCESS_NO_ACCESS;
+        D3D12_BARRIER_LAYOUT layout = D3D12_BARRIER_LAYOUT_COMMON;
+    };
+
+    EnhancedState ToEnhanced(D3D12_RESOURCE_STATES state)
+    {
+        EnhancedState e;
+
+        // COMMON / PRESENT: nothing on this queue touches the resource
+        if (state == D3D12_RESOURCE_STATE_COMMON)
+            return e;
+
+        struct Mapping
+        {
+            D3D12_RESOURCE_STATES state;
+            D3D12_BARRIER_SYNC sync;
+            D3D12_BARRIER_ACCESS access;
+            D3D12_BARRIER_LAYOUT layout;
+        };
+        static const Mapping kMappings[] =
+        {
+            { D3D12_RESOURCE_STATE_VERTEX_AND_CONSTANT_BUFFER, D3D12_BARRIER_SYNC_ALL_SHADING, D3D12_BARRIER_ACCESS_VERTEX_BUFFER | D3D12_BARRIER_ACCESS_CONSTANT_BUFFER, D3D12_BARRIER_LAYOUT_GENERIC_READ },
+            { D3D12_RESOURCE_STATE_INDEX_BUFFER, D3D12_BARRIER_SYNC_INDEX_INPUT, D3D12_BARRIER_ACCESS_INDEX_BUFFER, D3D12_BARRIER_LAYOUT_GENERIC_READ },
+            { D3D12_RESOURCE_STATE_RENDER_TARGET, D3D12_BARRIER_SYNC_RENDER_TARGET, D3D12_BARRIER_ACCESS_RENDER_TARGET, D3D12_BARRIER_LAYOUT_RENDER_TARGET },
+            { D3D12_RESOURCE_STATE_UNORDERED_ACCESS, D3D12_BARRIER_SYNC_ALL_SHADING, D3D12_BARRIER_ACCESS_UNORDERED_ACCESS, D3D12_BARRIER_LAYOUT_UNORDERED_ACCESS },
+            { D3D12_RESOURCE_STATE_DEPTH_WRITE, D3D12_BARRIER_SYNC_DEPTH_STENCIL, D3D12_BARRIER_ACCESS_DEPTH_STENCIL_WRITE, D3D12_BARRIER_LAYOUT_DEPTH_STENCIL_WRITE },
+            { D3D12_RESOURCE_STATE_DEPTH_READ, D3D12_BARRIER_SYNC_DEPTH_STENCIL, D3D12_BARRIER_ACCESS_DEPTH_STENCIL_READ, D3D12_BARRIER_LAYOUT_DEPTH_STENCIL_READ },
+            { D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE, D3D12_BARRIER_SYNC_NON_PIXEL_SHADING, D3D12_BARRIER_ACCESS_SHADER_RESOURCE, D3D12_BARRIER_LAYOUT_SHADER_RESOURCE },
+            { D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE, D3D12_BARRIER_SYNC_PIXEL_SHADING, D3D12_BARRIER_ACCESS_SHADER_RESOURCE, D3D12_BARRIER_LAYOUT_SHADER_RESOURCE },
+            { D3D12_RESOURCE_STATE_STREAM_OUT, D3D12_BARRIER_SYNC_VERTEX_SHADING, D3D12_BARRIER_ACCESS_STREAM_OUTPUT, D3D12_BARRIER_LAYOUT_COMMON },
+            { D3D12_RESOURCE_STATE_INDIRECT_ARGUMENT, D3D12_BARRIER_SYNC_EXECUTE_INDIRECT, D3D12_BARRIER_ACCESS_INDIRECT_ARGUMENT, D3D12_BARRIER_LAYOUT_GENERIC_READ },
+            { D3D12_RESOURCE_STATE_COPY_DEST, D3D12_BARRIER_SYNC_COPY, D3D12_BARRIER_ACCESS_COPY_DEST, D3D12_BARRIER_LAYOUT_COPY_DEST },
+            { D3D12_RESOURCE_STATE_COPY_SOURCE, D3D12_BARRIER_SYNC_COPY, D3D12_BARRIER_ACCESS_COPY_SOURCE, D3D12_BARRIER_LAYOUT_COPY_SOURCE },
+            { D3D12_RESOURCE_STATE_RESOLVE_DEST, D3D12_BARRIER_SYNC_RESOLVE, D3D12_BARRIER_ACCESS_RESOLVE_DEST, D3D12_BARRIER_LAYOUT_RESOLVE_DEST },
+            { D3D12_RESOURCE_STATE_RESOLVE_SOURCE, D3D12_BARRIER_SYNC_RESOLVE, D3D12_BARRIER_ACCESS_RESOLVE_SOURCE, D3D12_BARRIER_LAYOUT_RESOLVE_SOURCE },
+        };
+
+        UINT matches = 0;
+        e.access = D3D12_BARRIER_ACCESS_COMMON;
+        for (const Mapping& m : kMappings)
+        {
+            if ((state & m.state) != m.state) continue;
+            e.sync |= m.sync;
+            e.access |= m.access;
+            e.layout = m.layout;
+            ++matches;
+        }
+
+        // Several read states at once only fit the generic read layout
+        if (matches > 1)
+            e.layout = D3D12_BARRIER_LAYOUT_GENERIC_READ;
+        if (matches == 0)
+            e.sync = D3D12_BARRIER_SYNC_ALL;
+        return e;
+    }
+
+    uint64_t HashBytes(const void* data, size_t size, uint64_t hash)
+    {
+        const BYTE* bytes = static_cast<const BYTE*>(data);
+        for (size_t i = 0; i < size; ++i)
+        {
+            hash ^= bytes[i];
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+}
+
+// -----------------------------------------------------------
+// Building
+// -----------------------------------------------------------
+void FrameGraph::Reset()
+{
+    m_passes.clear();
+    m_resources.clear();
+    m_compiled = Compiled{};
+}
+
+FrameGraph::ResourceHandle FrameGraph::Import(const char* name, ID3D12Resource* resource,
+    D3D12_RESOURCE_STATES initialState, D3D12_RESOURCE_STATES finalState)
+{
+    Resource r;
+    r.name = name;
+    r.imported = true;
+    r.external = resource;
+    r.initialState = initialState;
+    r.finalState = finalState;
+    m_resources.push_back(r);
+    return static_cast<ResourceHandle>(m_resources.size() - 1);
+}
+
+FrameGraph::ResourceHandle FrameGraph::CreateTransient(const char* name, const TransientDesc& desc)
+{
+    Resource r;
+    r.name = name;
+    r.transient = desc;
+    m_resources.push_back(r);
+    return static_cast<ResourceHandle>(m_resources.size() - 1);
+}
+
+FrameGraph::PassHandle FrameGraph::AddPass(const char* name, ExecuteFn execute)
+{
+    Pass p;
+    p.name = name;
+    p.execute = std::move(execute);
+    m_passes.push_back(std::move(p));
+    return static_cast<PassHandle>(m_passes.size() - 1);
+}
+
+void FrameGraph::Read(PassHandle pass, ResourceHandle resource, D3D12_RESOURCE_STATES state)
+{
+    m_passes[pass].accesses.push_back({ resource, state, false });
+}
+
+void FrameGraph::Write(PassHandle pass, ResourceHandle resource, D3D12_RESOURCE_STATES state)
+{
+    m_passes[pass].accesses.push_back({ resource, state, true });
+}
+
+void FrameGraph::SetSideEffect(PassHandle pass)
+{
+    m_passes[pass].sideEffect = true;
+}
+
+bool FrameGraph::IsReadOnlyState(D3D12_RESOURCE_STATES state)
+{
+    // COMMON / PRESENT (0) is treated as a write-capable state
+    return state != D3D12_RESOURCE_STATE_COMMON && (state & kWriteStates) == 0;
+}
+
+// -----------------------------------------------------------
+// Compilation
+// -----------------------------------------------------------
+const FrameGraph::Compiled& FrameGraph::Compile()
+{
+    const uint32_t resourceCount = static_cast<uint32_t>(m_resources.size());
+
+    m_compiled = Compiled{};
+    m_compiled.heapOffsets.assign(resourceCount, 0);
+    m_compiled.createStates.assign(resourceCount, D3D12_RESOURCE_STATE_COMMON);
+    m_compiled.firstPass.assign(resourceCount, kInvalid);
+    m_compiled.lastPass.assign(resourceCount, kInvalid);
+
+    CullPasses();
+
+    std::vector<PassHandle> order;
+    for (PassHandle p = 0; p < m_passes.size(); ++p)
+        if (!m_compiled.culled[p]) order.push_back(p);
+
+    // Lifetimes, as indices into the execution order
+    std::vector<uint32_t> firstUse(resourceCount, kInvalid);
+    std::vector<uint32_t> lastUse(resourceCount, kInvalid);
+    for (uint32_t i = 0; i < order.size(); ++i)
+    {
+        for (const Access& a : m_passes[order[i]].accesses)
+        {
+            if (firstUse[a.resource] == kInvalid)
+            {
+                firstUse[a.resource] = i;
+                m_compiled.firstPass[a.resource] = order[i];
+            }
+            lastUse[a.resource] = i;
+            m_compiled.lastPass[a.resource] = order[i];
+        }
+    }
+
+    std::vector<ResourceHandle> aliasPredecessor(resourceCount, kInvalid);
+    std::vector<bool> aliased(resourceCount, false);
+    AssignHeapOffsets(firstUse, lastUse, aliasPredecessor, aliased);
+
+    // Walk the passes tracking every resource's state
+    std::vector<D3D12_RESOURCE_STATES> state(resourceCount, D3D12_RESOURCE_STATE_COMMON);
+    for (ResourceHandle r = 0; r < resourceCount; ++r)
+        if (m_resources[r].imported) state[r] = m_resources[r].initialState;
+
+    std::vector<Barrier> restores;
+    for (uint32_t i = 0; i < order.size(); ++i)
+    {
+        CompiledPass cp;
+        cp.pass = order[i];
+
+        // Transients that retired last pass go back to their creation
+        // state before anything else is placed on top of them
+        cp.barriers.swap(restores);
+
+        // Merge multiple accesses to one resource within the pass
+        std::vector<Access> merged;
+        for (const Access& a : m_passes[order[i]].accesses)
+        {
+            auto it = std::find_if(merged.begin(), merged.end(),
+                [&](const Access& m) { return m.resource == a.resource; });
+            if (it == merged.end())
+                merged.push_back(a);
+            else
+            {
+                it->state |= a.state;
+                it->write = it->write || a.write;
+            }
+        }
+
+        for (const Access& a : merged)
+        {
+            const ResourceHandle r = a.resource;
+
+            // First use of a transient: created directly in this state
+            if (!m_resources[r].imported && firstUse[r] == i)
+            {
+                m_compiled.createStates[r] = a.state;
+                state[r] = a.state;
+
+                if (aliased[r])
+                {
+                    Barrier b;
+                    b.type = Barrier::Type::Aliasing;
+                    b.resource = r;
+                    b.aliasBefore = aliasPredecessor[r];
+                    cp.barriers.push_back(b);
+                }
+                continue;
+            }
+
+            const D3D12_RESOURCE_STATES current = state[r];
+            if (current == a.state)
+            {
+                if (a.write && (a.state & D3D12_RESOURCE_STATE_UNORDERED_ACCESS))
+                {
+                    Barrier b;
+                    b.type = Barrier::Type::Uav;
+                    b.resource = r;
+                    cp.barriers.push_back(b);
+                }
+                continue;
+            }
+
+            // Already in a read state that covers this read
+            if (!a.write && IsReadOnlyState(a.state) && IsReadOnlyState(current) && (current & a.state) == a.state)
+                continue;
+
+            Barrier b;
+            b.resource = r;
+            b.before = current;
+            b.after = a.state;
+            cp.barriers.push_back(b);
+            state[r] = a.state;
+        }
+
+        for (const Access& a : merged)
+        {
+            const ResourceHandle r = a.resource;
+            if (m_resources[r].imported || lastUse[r] != i) continue;
+            if (state[r] == m_compiled.createStates[r]) continue;
+
+            Barrier b;
+            b.resource = r;
+            b.before = state[r];
+            b.after = m_compiled.createStates[r];
+            restores.push_back(b);
+        }
+
+        m_compiled.passes.push_back(std::move(cp));
+    }
+
+    m_compiled.finalBarriers.swap(restores);
+    for (ResourceHandle r = 0; r < resourceCount; ++r)
+    {
+        if (!m_resources[r].imported || state[r] == m_resources[r].finalState) continue;
+
+        Barrier b;
+        b.resource = r;
+        b.before = state[r];
+        b.after = m_resources[r].finalState;
+        m_compiled.finalBarriers.push_back(b);
+    }
+
+    return m_compiled;
+}
+
+D3D12_RENDER_PASS_RENDER_TARGET_DESC FrameGraph::RenderTargetAccess(PassHandle pass, ResourceHandle resource,
+    D3D12_CPU_DESCRIPTOR_HANDLE rtv, const D3D12_CLEAR_VALUE* clear) const
+{
+    const bool imported = m_resources[resource].imported;
+
+    D3D12_RENDER_PASS_RENDER_TARGET_DESC target{};
+    target.cpuDescriptor = rtv;
+
+    if (clear)
+    {
+        target.BeginningAccess.Type = D3D12_RENDER_PASS_BEGINNING_ACCESS_TYPE_CLEAR;
+        target.BeginningAccess.Clear.ClearValue = *clear;
+    }
+    else if (imported || m_compiled.firstPass[resource] != pass)
+        target.BeginningAccess.Type = D3D12_RENDER_PASS_BEGINNING_ACCESS_TYPE_PRESERVE;
+    else
+        target.BeginningAccess.Type = D3D12_RENDER_PASS_BEGINNING_ACCESS_TYPE_DISCARD;
+
+    if (imported || m_compiled.lastPass[resource] != pass)
+        target.EndingAccess.Type = D3D12_RENDER_PASS_ENDING_ACCESS_TYPE_PRESERVE;
+    else
+        target.EndingAccess.Type = D3D12_RENDER_PASS_ENDING_ACCESS_TYPE_DISCARD;
+
+    return target;
+}
+
+void FrameGraph::CullPasses()
+{
+    m_compiled.culled.assign(m_passes.size(), true);
+
+    // Walk backwards: a pass survives if it has side effects, writes an
+    // imported resource, or writes something a surviving pass reads
+    std::vector<bool> consumed(m_resources.size(), false);
+    for (size_t p = m_passes.size(); p-- > 0;)
+    {
+        const Pass& pass = m_passes[p];
+
+        bool needed = pass.sideEffect;
+        for (const Access& a : pass.accesses)
+            if (a.write && (m_resources[a.resource].imported || consumed[a.resource]))
+                needed = true;
+
+        if (!needed) continue;
+
+        m_compiled.culled[p] = false;
+        for (const Access& a : pass.accesses)
+            if (!a.write) consumed[a.resource] = true;
+    }
+}
+
+void FrameGraph::AssignHeapOffsets(const std::vector<uint32_t>& firstUse, const std::vector<uint32_t>& lastUse,
+    std::vector<ResourceHandle>& aliasPredecessor, std::vector<bool>& aliased)
+{
+    std::vector<ResourceHandle> transients;
+    for (ResourceHandle r = 0; r < m_resources.size(); ++r)
+        if (!m_resources[r].imported && firstUse[r] != kInvalid)
+            transients.push_back(r);
+
+    // Largest first keeps first-fit packing tight
+    std::sort(transients.begin(), transients.end(), [&](ResourceHandle a, ResourceHandle b)
+    {
+        const uint64_t sa = m_resources[a].transient.sizeInBytes;
+        const uint64_t sb = m_resources[b].transient.sizeInBytes;
+        return sa != sb ? sa > sb : a < b;
+    });
+
+    auto overlapsInTime = [&](ResourceHandle a, ResourceHandle b)
+    {
+        return firstUse[a] <= lastUse[b] && firstUse[b] <= lastUse[a];
+    };
+    auto overlapsInMemory = [&](ResourceHandle a, ResourceHandle b)
+    {
+        const uint64_t a0 = m_compiled.heapOffsets[a], a1 = a0 + m_resources[a].transient.sizeInBytes;
+        const uint64_t b0 = m_compiled.heapOffsets[b], b1 = b0 + m_resources[b].transient.sizeInBytes;
+        return a0 < b1 && b0 < a1;
+    };
+
+    std::vector<ResourceHandle> placed;
+    for (ResourceHandle r : transients)
+    {
+        const TransientDesc& t = m_resources[r].transient;
+        const uint64_t size = t.sizeInBytes ? t.sizeInBytes : 1;
+        const uint64_t alignment = t.alignment ? t.alignment : D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT;
+
+        std::vector<ResourceHandle> live;
+        for (ResourceHandle p : placed)
+            if (overlapsInTime(r, p)) live.push_back(p);
+        std::sort(live.begin(), live.end(), [&](ResourceHandle a, ResourceHandle b)
+        {
+            return m_compiled.heapOffsets[a] < m_compiled.heapOffsets[b];
+        });
+
+        // First gap large enough among the resources alive at the same time
+        uint64_t offset = 0;
+        for (ResourceHandle p : live)
+        {
+            const uint64_t begin = m_compiled.heapOffsets[p];
+            const uint64_t end = begin + m_resources[p].transient.sizeInBytes;
+            if (offset + size <= begin) break;
+            if (offset < end) offset = AlignUp(end, alignment);
+        }
+
+        m_compiled.heapOffsets[r] = offset;
+        m_compiled.transientHeapSize = (std::max)(m_compiled.transientHeapSize, offset + size);
+        placed.push_back(r);
+    }
+
+    // Resources sharing memory need an aliasing barrier on first use;
+    // the predecessor is the last one to use that memory before it
+    for (ResourceHandle r : placed)
+    {
+        for (ResourceHandle other : placed)
+        {
+            if (other == r || !overlapsInMemory(r, other)) continue;
+
+            aliased[r] = true;
+            if (lastUse[other] < firstUse[r] &&
+                (aliasPredecessor[r] == kInvalid || lastUse[other] > lastUse[aliasPredecessor[r]]))
+                aliasPredecessor[r] = other;
+        }
+    }
+}
+
+// -----------------------------------------------------------
+// Execution
+// -----------------------------------------------------------
+bool FrameGraph::Execute(ID3D12Device* device, const ListProvider& acquireList,
+    std::vector<ID3D12CommandList*>& outLists, UINT64 completedFence, UINT64 frameFence)
+{
+    if (!RealizeTransients(device, completedFence, frameFence))
+        return false;
+
+    m_acquire = &acquireList;
+    m_outLists = &outLists;
+
+    PassContext ctx;
+    ctx.m_graph = this;
+    if (!NextList(ctx)) return false;
+
+    for (const CompiledPass& cp : m_compiled.passes)
+    {
+        EmitBarriers(ctx.m_list, cp.barriers);
+
+        const Pass& pass = m_passes[cp.pass];
+        if (pass.execute) pass.execute(ctx);
+        if (ctx.m_failed) return false;
+    }
+
+    EmitBarriers(ctx.m_list, m_compiled.finalBarriers);
+    ctx.m_list->Close();
+    outLists.push_back(ctx.m_list);
+
+    m_acquire = nullptr;
+    m_outLists = nullptr;
+    return true;
+}
+
+bool FrameGraph::NextList(PassContext& ctx)
+{
+    ctx.m_list = (*m_acquire)();
+    return ctx.m_list != nullptr;
+}
+
+ID3D12Resource* FrameGraph::PassContext::Resource(ResourceHandle handle) const
+{
+    return m_graph->m_physical[handle];
+}
+
+void FrameGraph::PassContext::Splice(UINT count, ID3D12CommandList* const* lists)
+{
+    m_list->Close();
+    m_graph->m_outLists->push_back(m_list);
+    m_graph->m_outLists->insert(m_graph->m_outLists->end(), lists, lists + count);
+
+    if (!m_graph->NextList(*this))
+        m_failed = true;
+}
+
+void FrameGraph::EmitBarriers(ID3D12GraphicsCommandList* list, const std::vector<Barrier>& barriers)
+{
+    if (barriers.empty()) return;
+
+    if (m_enhancedBarriers)
+    {
+        ComPtr<ID3D12GraphicsCommandList7> list7;
+        if (SUCCEEDED(list->QueryInterface(IID_PPV_ARGS(&list7))))
+        {
+            EmitEnhancedBarriers(list7.Get(), barriers);
+            return;
+        }
+    }
+
+    EmitLegacyBarriers(list, barriers);
+}
+
+void FrameGraph::EmitLegacyBarriers(ID3D12GraphicsCommandList* list, const std::vector<Barrier>& barriers)
+{
+    std::vector<D3D12_RESOURCE_BARRIER> native;
+    native.reserve(barriers.size());
+    for (const Barrier& b : barriers)
+    {
+        ID3D12Resource* resource = m_physical[b.resource];
+        switch (b.type)
+        {
+        case Barrier::Type::Transition:
+            native.push_back(CD3DX12_RESOURCE_BARRIER::Transition(resource, b.before, b.after));
+            break;
+        case Barrier::Type::Uav:
+            native.push_back(CD3DX12_RESOURCE_BARRIER::UAV(resource));
+            break;
+        case Barrier::Type::Aliasing:
+            native.push_back(CD3DX12_RESOURCE_BARRIER::Aliasing(
+                b.aliasBefore != kInvalid ? m_physical[b.aliasBefore] : nullptr, resource));
+            break;
+        }
+    }
+
+    // One call per batch
+    list->ResourceBarrier(static_cast<UINT>(native.size()), native.data());
+}
+
+void FrameGraph::EmitEnhancedBarriers(ID3D12GraphicsCommandList7* list, const std::vector<Barrier>& barriers)
+{
+    std::vector<D3D12_TEXTURE_BARRIER> textures;
+    std::vector<D3D12_BUFFER_BARRIER> buffers;
+
+    for (const Barrier& b : barriers)
+    {
+        ID3D12Resource* resource = m_physical[b.resource];
+        const bool isBuffer = resource->GetDesc().Dimension == D3D12_RESOURCE_DIMENSION_BUFFER;
+
+        EnhancedState before = ToEnhanced(b.before);
+        EnhancedState after = ToEnhanced(b.after);
+        D3D12_TEXTURE_BARRIER_FLAGS flags = D3D12_TEXTURE_BARRIER_FLAG_NONE;
+
+        switch (b.type)
+        {
+        case Barrier::Type::Transition:
+            break;
+
+        case Barrier::Type::Uav:
+            before = after = ToEnhanced(D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
+            break;
+
+        case Barrier::Type::Aliasing:
+            // Wait for whatever used the memory before, then start from
+            // undefined contents in the creation layout
+            before.sync = D3D12_BARRIER_SYNC_ALL;
+            before.access = D3D12_BARRIER_ACCESS_NO_ACCESS;
+            before.layout = D3D12_BARRIER_LAYOUT_UNDEFINED;
+            after = ToEnhanced(m_compiled.createStates[b.resource]);
+            flags = D3D12_TEXTURE_BARRIER_FLAG_DISCARD;
+            break;
+        }
+
+        if (isBuffer)
+        {
+            buffers.push_back(CD3DX12_BUFFER_BARRIER(before.sync, after.sync, before.access, after.access, resource));
+        }
+        else
+        {
+            // All subresources
+            textures.push_back(CD3DX12_TEXTURE_BARRIER(before.sync, after.sync, before.access, after.access,
+                before.layout, after.layout, resource, CD3DX12_BARRIER_SUBRESOURCE_RANGE(0xFFFFFFFF), flags));
+        }
+    }
+
+    D3D12_BARRIER_GROUP groups[2];
+    UINT32 groupCount = 0;
+    if (!textures.empty())
+        groups[groupCount++] = CD3DX12_BARRIER_GROUP(static_cast<UINT32>(textures.size()), textures.data());
+    if (!buffers.empty())
+        groups[groupCount++] = CD3DX12_BARRIER_GROUP(static_cast<UINT32>(buffers.size()), buffers.data());
+
+    // One call per batch
+    list->Barrier(groupCount, groups);
+}
+
+bool FrameGraph::RealizeTransients(ID3D12Device* device, UINT64 completedFence, UINT64 frameFence)
+{
+    m_retired.erase(std::remove_if(m_retired.begin(), m_retired.end(),
+        [&](const Retired& r) { return r.fence <= completedFence; }), m_retired.end());
+
+    m_physical.assign(m_resources.size(), nullptr);
+    for (ResourceHandle r = 0; r < m_resources.size(); ++r)
+        if (m_resources[r].imported) m_physical[r] = m_resources[r].external;
+
+    const uint64_t required = m_compiled.transientHeapSize;
+    if (required == 0) return true;
+
+    if (!m_heap || m_heapSize < required)
+    {
+        // Everything placed in the old heap goes with it
+        Retired retired;
+        retired.heap = m_heap;
+        retired.fence = frameFence;
+        for (auto& kv : m_transients)
+            retired.resources.push_back(kv.second.resource);
+        m_retired.push_back(std::move(retired));
+        m_transients.clear();
+
+        // Tier 1 heaps cannot mix buffers and RT/DS textures
+        D3D12_FEATURE_DATA_D3D12_OPTIONS options{};
+        device->CheckFeatureSupport(D3D12_FEATURE_D3D12_OPTIONS, &options, sizeof(options));
+
+        uint64_t alignment = D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT;
+        for (const Resource& r : m_resources)
+            if (!r.imported) alignment = (std::max)(alignment, r.transient.alignment);
+
+        // Grow with headroom so that size-dependent transients (e.g. while
+        // drag-resizing) are re-placed in the existing heap instead of
+        // forcing a new heap every frame
+        D3D12_HEAP_DESC desc{};
+        desc.SizeInBytes = AlignUp(required + required / 4, alignment);
+        desc.Properties = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_DEFAULT);
+        desc.Alignment = alignment;
+        desc.Flags = options.ResourceHeapTier >= D3D12_RESOURCE_HEAP_TIER_2
+            ? D3D12_HEAP_FLAG_ALLOW_ALL_BUFFERS_AND_TEXTURES
+            : D3D12_HEAP_FLAG_ALLOW_ONLY_RT_DS_TEXTURES;
+
+        m_heap.Reset();
+        if (FAILED(device->CreateHeap(&desc, IID_PPV_ARGS(&m_heap))))
+            return false;
+        m_heapSize = desc.SizeInBytes;
+    }
+
+    for (ResourceHandle r = 0; r < m_resources.size(); ++r)
+    {
+        const Resource& res = m_resources[r];
+        if (res.imported) continue;
+
+        // Never used this frame (culled)
+        const bool used = std::any_of(m_compiled.passes.begin(), m_compiled.passes.end(), [&](const CompiledPass& cp)
+        {
+            for (const Access& a : m_passes[cp.pass].accesses)
+                if (a.resource == r) return true;
+            return false;
+        });
+        if (!used) continue;
+
+        uint64_t key = HashBytes(&res.transient.desc, sizeof(res.transient.desc), 14695981039346656037ull);
+        key = HashBytes(&m_compiled.heapOffsets[r], sizeof(uint64_t), key);
+        key = HashBytes(&m_compiled.createStates[r], sizeof(D3D12_RESOURCE_STATES), key);
+
+        CachedTransient& cached = m_transients[res.name];
+        if (!cached.resource || cached.key != key)
+        {
+            if (cached.resource)
+            {
+                Retired retired;
+                retired.fence = frameFence;
+                retired.resources.push_back(cached.resource);
+                m_retired.push_back(std::move(retired));
+                cached.resource.Reset();
+            }
+
+            if (FAILED(device->CreatePlacedResource(m_heap.Get(), m_compiled.heapOffsets[r], &res.transient.desc,
+                m_compiled.createStates[r], res.transient.hasClearValue ? &res.transient.clearValue : nullptr,
+                IID_PPV_ARGS(&cached.resource))))
+                return false;
+            cached.key = key;
+        }
+
+        m_physical[r] = cached.resource.Get();
+    }
+    return true;
+}
@@ -0,0 +1,194 @@
+#pragma once
+
+#include <windows.h>
+#include <wrl.h>
+#include <d3d12.h>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using Microsoft::WRL::ComPtr;
+
+// -----------------------------------------------------------
+// FrameGraph
+//   Passes declare which resources they read and write (and in
+//   which state). Compile() then
+//     - culls passes whose results are never consumed,
+//     - batches every state change a pass needs into one barrier
+//       list (one ResourceBarrier call per pass),
+//     - places transient resources whose lifetimes never overlap
+//       at the same offset of one shared heap.
+//   Compile() is pure CPU; the Compiled result can be inspected
+//   without a device. Execute() realizes transients and records.
+//
+//   Barriers are emitted either as legacy resource-state barriers or,
+//   when enabled and the list supports ID3D12GraphicsCommandList7,
+//   as enhanced sync/access/layout barriers.
+// -----------------------------------------------------------
+class FrameGraph
+{
+public:
+    using ResourceHandle = uint32_t;
+    using PassHandle = uint32_t;
+    static constexpr uint32_t kInvalid = 0xFFFFFFFFu;
+
+    struct TransientDesc
+    {
+        D3D12_RESOURCE_DESC desc{};
+        uint64_t sizeInBytes = 0;   ///< from GetResourceAllocationInfo
+        uint64_t alignment = D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT;
+        bool hasClearValue = false;
+        D3D12_CLEAR_VALUE clearValue{};
+    };
+
+    struct Barrier
+    {
+        enum class Type { Transition, Uav, Aliasing };
+
+        Type type = Type::Transition;
+        ResourceHandle resource = kInvalid;
+        ResourceHandle aliasBefore = kInvalid;   ///< Aliasing only (kInvalid = none)
+        D3D12_RESOURCE_STATES before = D3D12_RESOURCE_STATE_COMMON;
+        D3D12_RESOURCE_STATES after = D3D12_RESOURCE_STATE_COMMON;
+    };
+
+    struct CompiledPass
+    {
+        PassHandle pass = kInvalid;
+        std::vector<Barrier> barriers;  ///< issued as one batch before the pass
+    };
+
+    struct Compiled
+    {
+        std::vector<CompiledPass> passes;       ///< execution order, culled passes removed
+        std::vector<Barrier> finalBarriers;     ///< one batch after the last pass
+        std::vector<bool> culled;               ///< per declared pass
+        std::vector<uint64_t> heapOffsets;      ///< per resource (transients only)
+        std::vector<D3D12_RESOURCE_STATES> createStates; ///< per resource (transients only)
+        std::vector<PassHandle> firstPass;      ///< per resource, first surviving pass to access it
+        std::vector<PassHandle> lastPass;       ///< per resource, last surviving pass to access it
+        uint64_t transientHeapSize = 0;
+    };
+
+    class PassContext
+    {
+    public:
+        /// List to record into (already has this pass's barriers).
+        ID3D12GraphicsCommandList* List() const { return m_list; }
+        ID3D12Resource* Resource(ResourceHandle handle) const;
+
+        /// Inserts externally recorded, closed lists at this point of
+        /// the frame (e.g. from ParallelRecorder). Recording continues
+        /// in a fresh list afterwards.
+        void Splice(UINT count, ID3D12CommandList* const* lists);
+
+    private:
+        friend class FrameGraph;
+        FrameGraph* m_graph = nullptr;
+        ID3D12GraphicsCommandList* m_list = nullptr;
+        bool m_failed = false;
+    };
+
+    using ExecuteFn = std::function<void(PassContext& ctx)>;
+    using ListProvider = std::function<ID3D12GraphicsCommandList*()>;
+
+    // Building (every frame)
+    void Reset();
+    ResourceHandle Import(const char* name, ID3D12Resource* resource,
+        D3D12_RESOURCE_STATES initialState, D3D12_RESOURCE_STATES finalState);
+    ResourceHandle CreateTransient(const char* name, const TransientDesc& desc);
+    PassHandle AddPass(const char* name, ExecuteFn execute);
+    void Read(PassHandle pass, ResourceHandle resource, D3D12_RESOURCE_STATES state);
+    void Write(PassHandle pass, ResourceHandle resource, D3D12_RESOURCE_STATES state);
+    void SetSideEffect(PassHandle pass);
+
+    // Compilation (pure CPU)
+    const Compiled& Compile();
+    const Compiled& GetCompiled() const { return m_compiled; }
+
+    // Execution. Transient heaps / placed resources are cached across
+    // frames; anything replaced is kept until completedFence passes frameFence.
+    bool Execute(ID3D12Device* device, const ListProvider& acquireList,
+        std::vector<ID3D12CommandList*>& outLists, UINT64 completedFence, UINT64 frameFence);
+
+    /// Enables the enhanced-barrier backend (caller checks device support).
+    void SetEnhancedBarriers(bool enabled) { m_enhancedBarriers = enabled; }
+    bool UsesEnhancedBarriers() const { return m_enhancedBarriers; }
+
+    /// Render-pass access for a render target written by a pass. Contents
+    /// are loaded only if an earlier pass (or the caller) produced them and
+    /// stored only if a later pass (or the caller) reads them.
+    D3D12_RENDER_PASS_RENDER_TARGET_DESC RenderTargetAccess(PassHandle pass, ResourceHandle resource,
+        D3D12_CPU_DESCRIPTOR_HANDLE rtv, const D3D12_CLEAR_VALUE* clear) const;
+
+    static bool IsReadOnlyState(D3D12_RESOURCE_STATES state);
+
+private:
+    struct Access
+    {
+        ResourceHandle resource;
+        D3D12_RESOURCE_STATES state;
+        bool write;
+    };
+
+    struct Pass
+    {
+        std::string name;
+        ExecuteFn execute;
+        std::vector<Access> accesses;
+        bool sideEffect = false;
+    };
+
+    struct Resource
+    {
+        std::string name;
+        bool imported = false;
+        ID3D12Resource* external = nullptr;
+        D3D12_RESOURCE_STATES initialState = D3D12_RESOURCE_STATE_COMMON;
+        D3D12_RESOURCE_STATES finalState = D3D12_RESOURCE_STATE_COMMON;
+        TransientDesc transient;
+    };
+
+    // Placed transient kept across frames
+    struct CachedTransient
+    {
+        ComPtr<ID3D12Resource> resource;
+        uint64_t key = 0;
+    };
+
+    struct Retired
+    {
+        ComPtr<ID3D12Heap> heap;
+        std::vector<ComPtr<ID3D12Resource>> resources;
+        UINT64 fence = 0;
+    };
+
+    void CullPasses();
+    void AssignHeapOffsets(const std::vector<uint32_t>& firstUse, const std::vector<uint32_t>& lastUse,
+        std::vector<ResourceHandle>& aliasPredecessor, std::vector<bool>& aliased);
+    bool RealizeTransients(ID3D12Device* device, UINT64 completedFence, UINT64 frameFence);
+    void EmitBarriers(ID3D12GraphicsCommandList* list, const std::vector<Barrier>& barriers);
+    void EmitLegacyBarriers(ID3D12GraphicsCommandList* list, const std::vector<Barrier>& barriers);
+    void EmitEnhancedBarriers(ID3D12GraphicsCommandList7* list, const std::vector<Barrier>& barriers);
+    bool NextList(PassContext& ctx);
+
+private:
+    std::vector<Pass> m_passes;
+    std::vector<Resource> m_resources;
+    Compiled m_compiled;
+
+    bool m_enhancedBarriers = false;
+
+    // Execution state
+    std::vector<ID3D12Resource*> m_physical;
+    const ListProvider* m_acquire = nullptr;
+    std::vector<ID3D12CommandList*>* m_outLists = nullptr;
+
+    // Transient memory
+    ComPtr<ID3D12Heap> m_heap;
+    uint64_t m_heapSize = 0;
+    std::unordered_map<std::string, CachedTransient> m_transients;
+    std::vector<Retired> m_retired;
+};
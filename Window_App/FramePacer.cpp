@@ -0,0 +1,153 @@
+#include "FramePacer.h"
+#include <cmath>
+
+namespace
+{
+    // Weight of a new sample in the running estimates
+    const double kSmoothing = 1.0 / 8.0;
+
+    // Slack kept between the predicted finish and the deadline, in periods
+    const double kSafetyMargin = 0.1;
+}
+
+FramePacer::FramePacer()
+{
+    LARGE_INTEGER freq;
+    QueryPerformanceFrequency(&freq);
+    m_frequency = static_cast<uint64_t>(freq.QuadPart);
+
+    // High-resolution timers need Windows 10 1803+; fall back to a regular one
+    m_timer = CreateWaitableTimerExW(nullptr, nullptr, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+    if (!m_timer)
+        m_timer = CreateWaitableTimerExW(nullptr, nullptr, 0, TIMER_ALL_ACCESS);
+}
+
+FramePacer::~FramePacer()
+{
+    if (m_timer) CloseHandle(m_timer);
+}
+
+void FramePacer::SetTargetFps(UINT fps)
+{
+    m_targetFps = fps;
+    m_period = fps ? m_frequency / fps : 0;
+    m_deadline = 0;
+}
+
+uint64_t FramePacer::Now() const
+{
+    LARGE_INTEGER t;
+    QueryPerformanceCounter(&t);
+    return static_cast<uint64_t>(t.QuadPart);
+}
+
+// -----------------------------------------------------------
+// Prediction
+// -----------------------------------------------------------
+void FramePacer::Estimate::Add(double sample)
+{
+    if (!valid)
+    {
+        mean = sample;
+        deviation = sample / 2.0;
+        valid = true;
+        return;
+    }
+
+    deviation += kSmoothing * (std::fabs(sample - mean) - deviation);
+    mean += kSmoothing * (sample - mean);
+}
+
+uint64_t FramePacer::PredictedCost() const
+{
+    double cost = 0.0;
+    if (m_cpu.valid) cost += m_cpu.Predict();
+    if (m_gpu.valid) cost += m_gpu.Predict();
+    return static_cast<uint64_t>(cost);
+}
+
+void FramePacer::OnGpuCost(uint64_t gpuTicks, uint64_t gpuFrequency)
+{
+    if (gpuFrequency == 0) return;
+    m_gpu.Add(static_cast<double>(gpuTicks) * m_frequency / gpuFrequency);
+}
+
+// -----------------------------------------------------------
+// Pacing
+// -----------------------------------------------------------
+void FramePacer::WaitForFrameStart()
+{
+    const uint64_t now = Now();
+    const uint64_t cost = PredictedCost();
+
+    if (m_period == 0)
+    {
+        m_frameStart = now;
+        return;
+    }
+
+    // First frame, or the previous deadline is already out of reach
+    // (idle, hitch): schedule from now and start immediately
+    if (m_deadline == 0 || now + cost > m_deadline + m_period)
+    {
+        m_deadline = now + (cost > m_period ? cost : m_period);
+        m_frameStart = now;
+        return;
+    }
+
+    // Latest start that still meets the deadline
+    const uint64_t margin = static_cast<uint64_t>(m_period * kSafetyMargin);
+    const uint64_t reserve = cost + margin;
+    const uint64_t start = m_deadline > reserve ? m_deadline - reserve : 0;
+    if (start > now)
+        SleepUntil(start);
+
+    m_frameStart = Now();
+}
+
+void FramePacer::SleepUntil(uint64_t target)
+{
+    const uint64_t now = Now();
+    if (!m_timer || target <= now) return;
+
+    // Relative due time in 100ns units (negative = relative)
+    LARGE_INTEGER due;
+    due.QuadPart = -static_cast<LONGLONG>((target - now) * 10000000 / m_frequency);
+    if (SetWaitableTimer(m_timer, &due, 0, nullptr, nullptr, FALSE))
+        WaitForSingleObject(m_timer, INFINITE);
+}
+
+void FramePacer::OnPresent(uint64_t now)
+{
+    m_cpu.Add(static_cast<double>(now - m_frameStart));
+
+    if (m_lastPresent)
+        m_intervals[m_frames % kHistorySize] = static_cast<double>(now - m_lastPresent);
+    m_lastPresent = now;
+    ++m_frames;
+
+    if (m_period == 0) return;
+
+    if (now > m_deadline)
+        ++m_missed;
+    m_deadline += m_period;
+}
+
+double FramePacer::JitterMs() const
+{
+    // The first frame has no interval
+    const uint64_t count = (m_frames < kHistorySize ? m_frames : kHistorySize);
+    if (count < 3) return 0.0;
+
+    const uint64_t first = m_frames < kHistorySize ? 1 : 0;
+    double mean = 0.0;
+    for (uint64_t i = first; i < count; ++i) mean += m_intervals[i];
+    mean /= static_cast<double>(count - first);
+
+    double variance = 0.0;
+    for (uint64_t i = first; i < count; ++i)
+        variance += (m_intervals[i] - mean) * (m_intervals[i] - mean);
+    variance /= static_cast<double>(count - first);
+
+    return ToMs(static_cast<uint64_t>(std::sqrt(variance)));
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <windows.h>
+#include <array>
+#include <cstdint>
+
+// -----------------------------------------------------------
+// FramePacer
+//   Deadline-based frame pacing. Every frame has a present
+//   deadline one period after the previous one. The pacer predicts
+//   how long the next frame will take (CPU recording + GPU work,
+//   from recent history) and sleeps until the latest start time
+//   that still meets the deadline, so input is sampled as late as
+//   possible without missing the frame.
+//
+//   Sleeping uses a high-resolution waitable timer (a regular one
+//   before Windows 10 1803); the pacer never spins.
+//
+//   Per frame:
+//     WaitForFrameStart()     before sampling input
+//     OnGpuCost(ticks, freq)  once the frame's timestamps are read back
+//     OnPresent(now)          right after Present
+//   Time values are QueryPerformanceCounter ticks.
+// -----------------------------------------------------------
+class FramePacer
+{
+public:
+    static constexpr uint32_t kHistorySize = 128;
+
+    FramePacer();
+    ~FramePacer();
+
+    FramePacer(const FramePacer&) = delete;
+    FramePacer& operator=(const FramePacer&) = delete;
+
+    /// 0 disables pacing (WaitForFrameStart returns immediately).
+    void SetTargetFps(UINT fps);
+    UINT TargetFps() const { return m_targetFps; }
+
+    /// Blocks until the latest safe start time of the next frame.
+    void WaitForFrameStart();
+
+    /// GPU time of a completed frame, in the queue's timestamp ticks.
+    void OnGpuCost(uint64_t gpuTicks, uint64_t gpuFrequency);
+
+    /// Closes the frame started by the last WaitForFrameStart.
+    void OnPresent(uint64_t now);
+
+    // Statistics
+    double PredictedCostMs() const { return ToMs(PredictedCost()); }
+    double JitterMs() const;                        ///< std-dev of present intervals (recent history)
+    uint64_t MissedDeadlines() const { return m_missed; }
+    uint64_t FrameCount() const { return m_frames; }
+
+private:
+    // Running estimate of a cost: smoothed mean plus smoothed deviation
+    struct Estimate
+    {
+        double mean = 0.0;      ///< ticks
+        double deviation = 0.0; ///< ticks
+        bool valid = false;
+
+        void Add(double sample);
+        double Predict() const { return mean + 4.0 * deviation; }
+    };
+
+    uint64_t Now() const;
+    uint64_t PredictedCost() const;
+    double ToMs(uint64_t ticks) const { return ticks * 1000.0 / m_frequency; }
+    void SleepUntil(uint64_t target);
+
+private:
+    HANDLE m_timer = nullptr;
+    uint64_t m_frequency = 1;
+    uint64_t m_period = 0;          ///< ticks per frame (0 = pacing off)
+    UINT m_targetFps = 0;
+
+    uint64_t m_deadline = 0;        ///< present deadline of the current frame (0 = not scheduled)
+    uint64_t m_frameStart = 0;
+    uint64_t m_lastPresent = 0;
+
+    Estimate m_cpu;
+    Estimate m_gpu;
+
+    std::array<double, kHistorySize> m_intervals{};  ///< present-to-present, ticks
+    uint64_t m_frames = 0;
+    uint64_t m_missed = 0;
+};
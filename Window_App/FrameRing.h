@@ -0,0 +1,86 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+// -----------------------------------------------------------
+// FrameRing
+//   Ring of per-frame contexts whose depth is chosen at startup.
+//   A slot is reused only after the fence value signaled for it
+//   has completed, so the CPU can run up to (frameCount - 1)
+//   frames ahead of the GPU before it has to wait.
+//
+//   TFence must provide:
+//     uint64_t GetCompletedValue();
+//     void     WaitForValue(uint64_t value);
+//   so the ring can be driven by a mock fence without a device.
+// -----------------------------------------------------------
+template <typename TContext, uint32_t MaxFrames = 4>
+class FrameRing
+{
+public:
+    static constexpr uint32_t kMinFrames = 2;
+    static constexpr uint32_t kMaxFrames = MaxFrames;
+
+    explicit FrameRing(uint32_t frameCount = kMinFrames)
+    {
+        Resize(frameCount);
+    }
+
+    /// Changes the ring depth (clamped to [kMinFrames, kMaxFrames]).
+    /// Only valid while no frame is in flight.
+    void Resize(uint32_t frameCount)
+    {
+        if (frameCount < kMinFrames) frameCount = kMinFrames;
+        if (frameCount > kMaxFrames) frameCount = kMaxFrames;
+        m_frameCount = frameCount;
+        m_index = 0;
+        m_fenceValues.fill(0);
+        m_waitCount = 0;
+    }
+
+    /// Waits (only if needed) until the current slot is free on the GPU
+    /// and returns its context for recording.
+    template <typename TFence>
+    TContext& BeginFrame(TFence& fence)
+    {
+        const uint64_t required = m_fenceValues[m_index];
+        if (required != 0 && fence.GetCompletedValue() < required)
+        {
+            fence.WaitForValue(required);
+            ++m_waitCount;
+        }
+        return m_contexts[m_index];
+    }
+
+    /// Records the fence value that retires the current slot and advances.
+    void EndFrame(uint64_t signaledValue)
+    {
+        m_fenceValues[m_index] = signaledValue;
+        m_index = (m_index + 1) % m_frameCount;
+    }
+
+    /// Highest fence value handed to EndFrame (0 if none).
+    uint64_t LastSignaledValue() const
+    {
+        uint64_t value = 0;
+        for (uint32_t i = 0; i < m_frameCount; ++i)
+            if (m_fenceValues[i] > value) value = m_fenceValues[i];
+        return value;
+    }
+
+    TContext& operator[](uint32_t i) { return m_contexts[i]; }
+    const TContext& operator[](uint32_t i) const { return m_contexts[i]; }
+
+    TContext& Current() { return m_contexts[m_index]; }
+    uint32_t CurrentIndex() const { return m_index; }
+    uint32_t FrameCount() const { return m_frameCount; }
+    uint64_t WaitCount() const { return m_waitCount; }
+
+private:
+    std::array<TContext, MaxFrames> m_contexts{};
+    std::array<uint64_t, MaxFrames> m_fenceValues{};
+    uint32_t m_frameCount = kMinFrames;
+    uint32_t m_index = 0;
+    uint64_t m_waitCount = 0;
+};
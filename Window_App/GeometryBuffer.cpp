@@ -0,0 +1,171 @@
+#include "GeometryBuffer.h"
+#include "CopyUploader.h"
+
+// -----------------------------------------------------------
+// Setup / teardown
+// -----------------------------------------------------------
+bool GeometryBuffer::Initialize(GpuAllocator* allocator, CopyUploader* uploader, UINT vertexStride,
+    UINT verticesPerChunk, UINT indicesPerChunk)
+{
+    m_allocator = allocator;
+    m_uploader = uploader;
+    m_vertexStride = vertexStride;
+    m_verticesPerChunk = verticesPerChunk;
+    m_indicesPerChunk = indicesPerChunk;
+    return m_allocator && m_uploader && m_vertexStride > 0;
+}
+
+void GeometryBuffer::Shutdown()
+{
+    for (auto& chunk : m_chunks)
+    {
+        m_allocator->Free(chunk->vertexBuffer);
+        m_allocator->Free(chunk->indexBuffer);
+    }
+    m_chunks.clear();
+}
+
+bool GeometryBuffer::AddChunk(UINT vertexCount, UINT indexCount)
+{
+    // A mesh larger than the default chunk gets a chunk of its own size,
+    // including the allocator's size-class rounding
+    vertexCount = static_cast<UINT>(TlsfAllocator::RequiredCapacity(vertexCount, 1, 1));
+    indexCount = static_cast<UINT>(TlsfAllocator::RequiredCapacity(indexCount, 1, 1));
+    if (vertexCount < m_verticesPerChunk) vertexCount = m_verticesPerChunk;
+    if (indexCount < m_indicesPerChunk) indexCount = m_indicesPerChunk;
+
+    std::unique_ptr<Chunk> chunk(new Chunk);
+    const UINT64 vbSize = static_cast<UINT64>(vertexCount) * m_vertexStride;
+    const UINT64 ibSize = static_cast<UINT64>(indexCount) * sizeof(uint16_t);
+
+    // COMMON: promoted to COPY_DEST by the copy queue, read implicitly afterwards
+    if (!m_allocator->CreateBuffer(D3D12_HEAP_TYPE_DEFAULT, vbSize, D3D12_RESOURCE_STATE_COMMON, chunk->vertexBuffer))
+        return false;
+    if (!m_allocator->CreateBuffer(D3D12_HEAP_TYPE_DEFAULT, ibSize, D3D12_RESOURCE_STATE_COMMON, chunk->indexBuffer))
+    {
+        m_allocator->Free(chunk->vertexBuffer);
+        return false;
+    }
+
+    chunk->vertexView.BufferLocation = chunk->vertexBuffer.resource->GetGPUVirtualAddress();
+    chunk->vertexView.SizeInBytes = static_cast<UINT>(vbSize);
+    chunk->vertexView.StrideInBytes = m_vertexStride;
+
+    chunk->indexView.BufferLocation = chunk->indexBuffer.resource->GetGPUVirtualAddress();
+    chunk->indexView.SizeInBytes = static_cast<UINT>(ibSize);
+    chunk->indexView.Format = DXGI_FORMAT_R16_UINT;
+
+    chunk->vertices.Reset(vertexCount, 1);
+    chunk->indices.Reset(indexCount, 1);
+
+    m_chunks.push_back(std::move(chunk));
+    return true;
+}
+
+void GeometryBuffer::RemoveLastChunk()
+{
+    Chunk& chunk = *m_chunks.back();
+    m_allocator->Free(chunk.vertexBuffer);
+    m_allocator->Free(chunk.indexBuffer);
+    m_chunks.pop_back();
+}
+
+// -----------------------------------------------------------
+// Meshes
+// -----------------------------------------------------------
+bool GeometryBuffer::AddMesh(const void* vertices, UINT vertexCount, const uint16_t* indices, UINT indexCount, MeshHandle& out)
+{
+    out = MeshHandle{};
+    if (vertexCount == 0 || indexCount == 0 || vertexCount > 65536)
+        return false;
+
+    // First chunk with room for both ranges
+    UINT32 chunkIndex = TlsfAllocator::kInvalid;
+    TlsfAllocator::Allocation vertexRange, indexRange;
+    for (UINT32 i = 0; i < m_chunks.size(); ++i)
+    {
+        Chunk& c = *m_chunks[i];
+        vertexRange = c.vertices.Allocate(vertexCount);
+        if (!vertexRange) continue;
+        indexRange = c.indices.Allocate(indexCount);
+        if (!indexRange)
+        {
+            c.vertices.Free(vertexRange.block);
+            continue;
+        }
+        chunkIndex = i;
+        break;
+    }
+
+    if (chunkIndex == TlsfAllocator::kInvalid)
+    {
+        if (!AddChunk(vertexCount, indexCount)) return false;
+        chunkIndex = static_cast<UINT32>(m_chunks.size() - 1);
+        vertexRange = m_chunks[chunkIndex]->vertices.Allocate(vertexCount);
+        indexRange = m_chunks[chunkIndex]->indices.Allocate(indexCount);
+        if (!vertexRange || !indexRange)
+        {
+            // Nothing refers to the new chunk yet
+            RemoveLastChunk();
+            return false;
+        }
+    }
+
+    // Page the chunk in before the copy queue writes it
+    Chunk& chunk = *m_chunks[chunkIndex];
+    MarkUsed(chunkIndex, TimelinePoint{});
+    if (!m_uploader->Upload(chunk.vertexBuffer.resource.Get(), vertexRange.offset * m_vertexStride,
+            vertices, static_cast<UINT64>(vertexCount) * m_vertexStride) ||
+        !m_uploader->Upload(chunk.indexBuffer.resource.Get(), indexRange.offset * sizeof(uint16_t),
+            indices, static_cast<UINT64>(indexCount) * sizeof(uint16_t)))
+    {
+        // A copy may already be queued into the chunk, so it stays (empty)
+        chunk.vertices.Free(vertexRange.block);
+        chunk.indices.Free(indexRange.block);
+        return false;
+    }
+
+    ++chunk.meshCount;
+    out.chunk = chunkIndex;
+    out.vertexBlock = vertexRange.block;
+    out.indexBlock = indexRange.block;
+    out.baseVertex = static_cast<INT>(vertexRange.offset);
+    out.startIndex = static_cast<UINT>(indexRange.offset);
+    out.indexCount = indexCount;
+    return true;
+}
+
+void GeometryBuffer::RemoveMesh(MeshHandle& mesh)
+{
+    if (!mesh) return;
+
+    // Freed ranges coalesce with free neighbours inside the chunk
+    Chunk& chunk = *m_chunks[mesh.chunk];
+    chunk.vertices.Free(mesh.vertexBlock);
+    chunk.indices.Free(mesh.indexBlock);
+    --chunk.meshCount;
+    mesh = MeshHandle{};
+}
+
+void GeometryBuffer::MarkUsed(UINT32 chunk, const TimelinePoint& point)
+{
+    m_allocator->MarkUsed(m_chunks[chunk]->vertexBuffer, point);
+    m_allocator->MarkUsed(m_chunks[chunk]->indexBuffer, point);
+}
+
+GeometryBuffer::Stats GeometryBuffer::GetStats() const
+{
+    Stats s;
+    s.chunkCount = static_cast<UINT32>(m_chunks.size());
+    for (const auto& chunk : m_chunks)
+    {
+        const TlsfAllocator::Stats v = chunk->vertices.GetStats();
+        const TlsfAllocator::Stats i = chunk->indices.GetStats();
+        s.meshCount += chunk->meshCount;
+        s.vertexCapacity += v.capacity;
+        s.verticesUsed += v.usedBytes;
+        s.indexCapacity += i.capacity;
+        s.indicesUsed += i.usedBytes;
+    }
+    return s;
+}
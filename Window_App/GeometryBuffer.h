@@ -0,0 +1,102 @@
+#pragma once
+
+#include <windows.h>
+#include <d3d12.h>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "GpuAllocator.h"
+#include "TlsfAllocator.h"
+
+class CopyUploader;
+
+// Where a mesh lives inside the shared geometry buffers
+struct MeshHandle
+{
+    UINT32 chunk = TlsfAllocator::kInvalid;     ///< kInvalid = no mesh
+    UINT32 vertexBlock = TlsfAllocator::kInvalid;
+    UINT32 indexBlock = TlsfAllocator::kInvalid;
+    INT baseVertex = 0;
+    UINT startIndex = 0;
+    UINT indexCount = 0;
+
+    explicit operator bool() const { return chunk != TlsfAllocator::kInvalid; }
+};
+
+// -----------------------------------------------------------
+// GeometryBuffer
+//   Mega-buffer suballocation for static meshes. Vertices and
+//   16-bit indices of many meshes share a few large DEFAULT-heap
+//   buffers (chunks); a mesh is a base vertex / start index into
+//   one chunk, so thousands of meshes bind the same two views and
+//   can be batched or drawn indirectly.
+//
+//   Ranges are managed in elements (vertices / indices) by a
+//   TlsfAllocator, so freed ranges coalesce with their neighbours
+//   and are reused. A new chunk is added when no existing one has
+//   room. Data is uploaded through CopyUploader; the caller flushes
+//   it, gates draws on the returned point and, with residency, stamps
+//   the chunk with it (MarkUsed).
+//
+//   Not thread-safe. RemoveMesh() frees immediately; the caller
+//   makes sure the GPU no longer reads the mesh.
+// -----------------------------------------------------------
+class GeometryBuffer
+{
+public:
+    struct Stats
+    {
+        UINT32 chunkCount = 0;
+        UINT32 meshCount = 0;
+        UINT64 vertexCapacity = 0;
+        UINT64 verticesUsed = 0;
+        UINT64 indexCapacity = 0;
+        UINT64 indicesUsed = 0;
+    };
+
+    GeometryBuffer() = default;
+
+    GeometryBuffer(const GeometryBuffer&) = delete;
+    GeometryBuffer& operator=(const GeometryBuffer&) = delete;
+
+    bool Initialize(GpuAllocator* allocator, CopyUploader* uploader, UINT vertexStride,
+        UINT verticesPerChunk = 1 << 20, UINT indicesPerChunk = 4 << 20);
+    void Shutdown();
+
+    /// Allocates ranges and queues the upload. Meshes must have at most 65536 vertices.
+    bool AddMesh(const void* vertices, UINT vertexCount, const uint16_t* indices, UINT indexCount, MeshHandle& out);
+    void RemoveMesh(MeshHandle& mesh);
+
+    /// Stamps a chunk with the work that reads or writes it: the frame
+    /// that draws from it, or the copy point of uploads into it (residency).
+    void MarkUsed(UINT32 chunk, const TimelinePoint& point);
+
+    const D3D12_VERTEX_BUFFER_VIEW& VertexView(UINT32 chunk) const { return m_chunks[chunk]->vertexView; }
+    const D3D12_INDEX_BUFFER_VIEW& IndexView(UINT32 chunk) const { return m_chunks[chunk]->indexView; }
+
+    Stats GetStats() const;
+
+private:
+    struct Chunk
+    {
+        GpuAllocation vertexBuffer;
+        GpuAllocation indexBuffer;
+        D3D12_VERTEX_BUFFER_VIEW vertexView{};
+        D3D12_INDEX_BUFFER_VIEW indexView{};
+        TlsfAllocator vertices;     ///< in vertices
+        TlsfAllocator indices;      ///< in indices
+        UINT32 meshCount = 0;
+    };
+
+    bool AddChunk(UINT vertexCount, UINT indexCount);
+    void RemoveLastChunk();
+
+private:
+    GpuAllocator* m_allocator = nullptr;
+    CopyUploader* m_uploader = nullptr;
+    UINT m_vertexStride = 0;
+    UINT m_verticesPerChunk = 0;
+    UINT m_indicesPerChunk = 0;
+    std::vector<std::unique_ptr<Chunk>> m_chunks;
+};
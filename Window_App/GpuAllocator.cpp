@@ -0,0 +1,259 @@
+#include "GpuAllocator.h"
+#include "ResidencyManager.h"
+#include "d3dx12.h"
+
+namespace
+{
+    UINT64 AlignUp(UINT64 value, UINT64 alignment)
+    {
+        return (value + alignment - 1) & ~(alignment - 1);
+    }
+}
+
+// -----------------------------------------------------------
+// Setup / teardown
+// -----------------------------------------------------------
+bool GpuAllocator::Initialize(ID3D12Device* device, UINT64 pageSize)
+{
+    m_device = device;
+    m_pageSize = AlignUp(pageSize, D3D12_DEFAULT_MSAA_RESOURCE_PLACEMENT_ALIGNMENT);
+
+    D3D12_FEATURE_DATA_D3D12_OPTIONS options{};
+    if (FAILED(device->CheckFeatureSupport(D3D12_FEATURE_D3D12_OPTIONS, &options, sizeof(options))))
+        return false;
+    m_heapTier = options.ResourceHeapTier;
+    return true;
+}
+
+void GpuAllocator::Shutdown()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (Pool& pool : m_pools)
+        for (auto& page : pool.pages)
+            if (page) ReleasePage(page);
+    m_pools.clear();
+}
+
+// -----------------------------------------------------------
+// Pools / pages
+// -----------------------------------------------------------
+GpuAllocator::Category GpuAllocator::Classify(const D3D12_RESOURCE_DESC& desc) const
+{
+    if (m_heapTier >= D3D12_RESOURCE_HEAP_TIER_2)
+        return Category::All;
+    if (desc.Dimension == D3D12_RESOURCE_DIMENSION_BUFFER)
+        return Category::Buffer;
+    if (desc.Flags & (D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET | D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL))
+        return Category::RenderTarget;
+    return Category::Texture;
+}
+
+UINT32 GpuAllocator::FindPool(D3D12_HEAP_TYPE heapType, Category category)
+{
+    for (UINT32 i = 0; i < m_pools.size(); ++i)
+        if (m_pools[i].heapType == heapType && m_pools[i].category == category)
+            return i;
+
+    Pool pool;
+    pool.heapType = heapType;
+    pool.category = category;
+    m_pools.push_back(std::move(pool));
+    return static_cast<UINT32>(m_pools.size() - 1);
+}
+
+GpuAllocator::Page* GpuAllocator::AddPage(Pool& pool, UINT64 size, UINT64 alignment, UINT32& outIndex)
+{
+    static const D3D12_HEAP_FLAGS kCategoryFlags[] =
+    {
+        D3D12_HEAP_FLAG_ALLOW_ONLY_BUFFERS,
+        D3D12_HEAP_FLAG_ALLOW_ONLY_NON_RT_DS_TEXTURES,
+        D3D12_HEAP_FLAG_ALLOW_ONLY_RT_DS_TEXTURES,
+        D3D12_HEAP_FLAG_ALLOW_ALL_BUFFERS_AND_TEXTURES,
+    };
+
+    // Oversized resources get a page of their own, big enough for the
+    // allocator's size-class rounding and alignment padding too
+    const UINT64 minSize = TlsfAllocator::RequiredCapacity(size, alignment, D3D12_SMALL_RESOURCE_PLACEMENT_ALIGNMENT);
+    D3D12_HEAP_DESC desc{};
+    desc.SizeInBytes = AlignUp(minSize > m_pageSize ? minSize : m_pageSize, D3D12_DEFAULT_MSAA_RESOURCE_PLACEMENT_ALIGNMENT);
+    desc.Properties = CD3DX12_HEAP_PROPERTIES(pool.heapType);
+    desc.Alignment = D3D12_DEFAULT_MSAA_RESOURCE_PLACEMENT_ALIGNMENT;   // MSAA textures may be placed too
+    desc.Flags = kCategoryFlags[static_cast<UINT>(pool.category)];
+
+    std::unique_ptr<Page> page(new Page);
+    if (FAILED(m_device->CreateHeap(&desc, IID_PPV_ARGS(&page->heap))))
+        return nullptr;
+    page->space.Reset(desc.SizeInBytes, D3D12_SMALL_RESOURCE_PLACEMENT_ALIGNMENT);
+
+    // Only video memory counts against the local budget
+    if (m_residency && pool.heapType == D3D12_HEAP_TYPE_DEFAULT)
+        page->residencyId = m_residency->Track(page->heap.Get(), desc.SizeInBytes);
+
+    // Reuse a released slot so page indices in live allocations stay valid
+    for (UINT32 i = 0; i < pool.pages.size(); ++i)
+    {
+        if (!pool.pages[i])
+        {
+            pool.pages[i] = std::move(page);
+            outIndex = i;
+            return pool.pages[i].get();
+        }
+    }
+    pool.pages.push_back(std::move(page));
+    outIndex = static_cast<UINT32>(pool.pages.size() - 1);
+    return pool.pages.back().get();
+}
+
+// -----------------------------------------------------------
+// Create / free
+// -----------------------------------------------------------
+bool GpuAllocator::CreateResource(D3D12_HEAP_TYPE heapType, const D3D12_RESOURCE_DESC& desc,
+    D3D12_RESOURCE_STATES initialState, const D3D12_CLEAR_VALUE* clearValue, GpuAllocation& out)
+{
+    D3D12_RESOURCE_DESC placed = desc;
+
+    // Small-resource rule: non-RT/DS, non-MSAA textures may use 4KB
+    // placement if the whole resource fits in one 64KB tile
+    D3D12_RESOURCE_ALLOCATION_INFO info{};
+    const bool smallCandidate = desc.Dimension != D3D12_RESOURCE_DIMENSION_BUFFER &&
+        desc.SampleDesc.Count <= 1 &&
+        !(desc.Flags & (D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET | D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL));
+    if (smallCandidate)
+    {
+        placed.Alignment = D3D12_SMALL_RESOURCE_PLACEMENT_ALIGNMENT;
+        info = m_device->GetResourceAllocationInfo(0, 1, &placed);
+    }
+    if (!smallCandidate || info.Alignment != D3D12_SMALL_RESOURCE_PLACEMENT_ALIGNMENT)
+    {
+        // 0 lets the runtime pick 64KB, or 4MB for MSAA
+        placed.Alignment = 0;
+        info = m_device->GetResourceAllocationInfo(0, 1, &placed);
+    }
+    if (info.SizeInBytes == UINT64_MAX)
+        return false;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    const UINT32 poolIndex = FindPool(heapType, Classify(desc));
+    Pool& pool = m_pools[poolIndex];
+
+    // First page with room, otherwise a new one
+    Page* page = nullptr;
+    UINT32 pageIndex = 0;
+    TlsfAllocator::Allocation range;
+    for (UINT32 i = 0; i < pool.pages.size() && !range; ++i)
+    {
+        if (!pool.pages[i]) continue;
+        range = pool.pages[i]->space.Allocate(info.SizeInBytes, info.Alignment);
+        if (range) { page = pool.pages[i].get(); pageIndex = i; }
+    }
+    bool newPage = false;
+    if (!range)
+    {
+        page = AddPage(pool, info.SizeInBytes, info.Alignment, pageIndex);
+        if (!page) return false;
+        newPage = true;
+        range = page->space.Allocate(info.SizeInBytes, info.Alignment);
+        if (!range)
+        {
+            ReleasePage(pool.pages[pageIndex]);
+            return false;
+        }
+    }
+
+    // An evicted page is made resident before anything is placed in or copied to it
+    if (m_residency && page->residencyId != TlsfAllocator::kInvalid)
+        m_residency->MarkUsed(page->residencyId, TimelinePoint{});
+
+    ComPtr<ID3D12Resource> resource;
+    if (FAILED(m_device->CreatePlacedResource(page->heap.Get(), range.offset, &placed, initialState,
+        clearValue, IID_PPV_ARGS(&resource))))
+    {
+        // A page made for this resource alone would otherwise stay tracked forever
+        if (newPage)
+            ReleasePage(pool.pages[pageIndex]);
+        else
+            page->space.Free(range.block);
+        return false;
+    }
+
+    out.resource = resource;
+    out.pool = poolIndex;
+    out.page = pageIndex;
+    out.block = range.block;
+    out.offset = range.offset;
+    out.size = range.size;
+    return true;
+}
+
+bool GpuAllocator::CreateBuffer(D3D12_HEAP_TYPE heapType, UINT64 size, D3D12_RESOURCE_STATES initialState, GpuAllocation& out)
+{
+    CD3DX12_RESOURCE_DESC desc = CD3DX12_RESOURCE_DESC::Buffer(size);
+    return CreateResource(heapType, desc, initialState, nullptr, out);
+}
+
+void GpuAllocator::Free(GpuAllocation& allocation)
+{
+    allocation.resource.Reset();
+    if (allocation.pool == TlsfAllocator::kInvalid) return;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    Pool& pool = m_pools[allocation.pool];
+    std::unique_ptr<Page>& page = pool.pages[allocation.page];
+    page->space.Free(allocation.block);
+
+    // Give empty pages back, but keep one per pool for the next resource
+    if (page->space.Empty())
+    {
+        UINT32 livePages = 0;
+        for (const auto& p : pool.pages)
+            if (p) ++livePages;
+        if (livePages > 1)
+            ReleasePage(page);
+    }
+
+    allocation = GpuAllocation{};
+}
+
+void GpuAllocator::ReleasePage(std::unique_ptr<Page>& page)
+{
+    if (m_residency && page->residencyId != TlsfAllocator::kInvalid)
+        m_residency->Untrack(page->residencyId);
+    page.reset();
+}
+
+void GpuAllocator::MarkUsed(const GpuAllocation& allocation, const TimelinePoint& point)
+{
+    if (!m_residency || allocation.pool == TlsfAllocator::kInvalid) return;
+
+    UINT32 residencyId;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        residencyId = m_pools[allocation.pool].pages[allocation.page]->residencyId;
+    }
+    if (residencyId != TlsfAllocator::kInvalid)
+        m_residency->MarkUsed(residencyId, point);
+}
+
+GpuAllocator::Stats GpuAllocator::GetStats() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    Stats s;
+    for (const Pool& pool : m_pools)
+    {
+        for (const auto& page : pool.pages)
+        {
+            if (!page) continue;
+            const TlsfAllocator::Stats ps = page->space.GetStats();
+            s.reservedBytes += ps.capacity;
+            s.usedBytes += ps.usedBytes;
+            s.allocationCount += ps.allocationCount;
+            ++s.heapCount;
+            if (ps.largestFreeBlock > s.largestFreeBlock) s.largestFreeBlock = ps.largestFreeBlock;
+            if (ps.Fragmentation() > s.fragmentation) s.fragmentation = ps.Fragmentation();
+        }
+    }
+    return s;
+}
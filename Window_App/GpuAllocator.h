@@ -0,0 +1,121 @@
+#pragma once
+
+#include <windows.h>
+#include <wrl.h>
+#include <d3d12.h>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "QueueScheduler.h"
+#include "TlsfAllocator.h"
+
+class ResidencyManager;
+
+using Microsoft::WRL::ComPtr;
+
+// One placed resource and where it lives
+struct GpuAllocation
+{
+    ComPtr<ID3D12Resource> resource;
+    UINT32 pool = TlsfAllocator::kInvalid;  ///< kInvalid = not from a heap (empty / committed)
+    UINT32 page = 0;
+    UINT32 block = TlsfAllocator::kInvalid;
+    UINT64 offset = 0;                      ///< within the page heap
+    UINT64 size = 0;
+
+    explicit operator bool() const { return resource != nullptr; }
+};
+
+// -----------------------------------------------------------
+// GpuAllocator
+//   Reserves large ID3D12Heaps (pages) per heap type and resource
+//   category and places resources into them with CreatePlacedResource,
+//   so creating a resource no longer means one OS-level allocation.
+//   Space inside a page is managed by a TlsfAllocator.
+//
+//   Alignment follows the placement rules:
+//     buffers / textures          64KB
+//     MSAA textures               4MB
+//     small textures (non RT/DS)  4KB when the driver allows it
+//   Resource heap tier 1 keeps buffers, RT/DS textures and other
+//   textures in separate heaps; tier 2 shares one heap per type.
+//
+//   With a ResidencyManager attached, DEFAULT-heap pages are tracked
+//   for budget-driven eviction; MarkUsed() stamps a page with the
+//   queue timeline point of the work that reads or writes it. A page
+//   is paged back in before a resource is placed in it.
+//
+//   Internally locked. Free() releases immediately; the caller
+//   makes sure the GPU is done with the resource.
+// -----------------------------------------------------------
+class GpuAllocator
+{
+public:
+    struct Stats
+    {
+        UINT64 reservedBytes = 0;   ///< sum of heap sizes
+        UINT64 usedBytes = 0;       ///< placed, including alignment padding
+        UINT64 largestFreeBlock = 0;
+        UINT32 heapCount = 0;
+        UINT32 allocationCount = 0;
+        double fragmentation = 0.0; ///< worst page: 1 - largest free block / free bytes
+
+        double Utilization() const { return reservedBytes ? static_cast<double>(usedBytes) / reservedBytes : 0.0; }
+    };
+
+    static constexpr UINT64 kDefaultPageSize = 64ull << 20;
+
+    GpuAllocator() = default;
+
+    GpuAllocator(const GpuAllocator&) = delete;
+    GpuAllocator& operator=(const GpuAllocator&) = delete;
+
+    bool Initialize(ID3D12Device* device, UINT64 pageSize = kDefaultPageSize);
+    void Shutdown();
+
+    bool CreateResource(D3D12_HEAP_TYPE heapType, const D3D12_RESOURCE_DESC& desc,
+        D3D12_RESOURCE_STATES initialState, const D3D12_CLEAR_VALUE* clearValue, GpuAllocation& out);
+
+    bool CreateBuffer(D3D12_HEAP_TYPE heapType, UINT64 size, D3D12_RESOURCE_STATES initialState, GpuAllocation& out);
+
+    /// Releases the resource and returns its range to the page.
+    void Free(GpuAllocation& allocation);
+
+    /// Pages created from now on are tracked for residency (DEFAULT heaps only).
+    void SetResidencyManager(ResidencyManager* residency) { m_residency = residency; }
+    void MarkUsed(const GpuAllocation& allocation, const TimelinePoint& point);
+
+    Stats GetStats() const;
+
+private:
+    enum class Category : UINT { Buffer, Texture, RenderTarget, All };
+
+    struct Page
+    {
+        ComPtr<ID3D12Heap> heap;
+        TlsfAllocator space;
+        UINT32 residencyId = TlsfAllocator::kInvalid;
+    };
+
+    struct Pool
+    {
+        D3D12_HEAP_TYPE heapType = D3D12_HEAP_TYPE_DEFAULT;
+        Category category = Category::All;
+        std::vector<std::unique_ptr<Page>> pages;   ///< nullptr = released
+    };
+
+    Category Classify(const D3D12_RESOURCE_DESC& desc) const;
+    UINT32 FindPool(D3D12_HEAP_TYPE heapType, Category category);
+    Page* AddPage(Pool& pool, UINT64 size, UINT64 alignment, UINT32& outIndex);
+    void ReleasePage(std::unique_ptr<Page>& page);
+
+private:
+    ID3D12Device* m_device = nullptr;
+    UINT64 m_pageSize = kDefaultPageSize;
+    D3D12_RESOURCE_HEAP_TIER m_heapTier = D3D12_RESOURCE_HEAP_TIER_1;
+    ResidencyManager* m_residency = nullptr;
+
+    mutable std::mutex m_mutex;
+    std::vector<Pool> m_pools;
+};
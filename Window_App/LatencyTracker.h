@@ -0,0 +1,90 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+// -----------------------------------------------------------
+// LatencyTracker
+//   Measures input-to-present latency per frame.
+//   Time values are raw QueryPerformanceCounter ticks.
+//
+//   UI side   : OnInput(now) for every input event
+//   Render    : SampleInput(now) right before recording,
+//               OnPresent(now) right after Present
+// -----------------------------------------------------------
+class LatencyTracker
+{
+public:
+    static constexpr uint32_t kHistorySize = 128;
+
+    struct FrameSample
+    {
+        double sampleToPresentMs = 0.0; ///< input sampling point -> Present returned
+        double inputToPresentMs = 0.0;  ///< oldest consumed input -> Present (0 = no input)
+    };
+
+    explicit LatencyTracker(uint64_t ticksPerSecond = 1) : m_ticksPerSecond(ticksPerSecond ? ticksPerSecond : 1) {}
+
+    void SetFrequency(uint64_t ticksPerSecond) { m_ticksPerSecond = ticksPerSecond ? ticksPerSecond : 1; }
+
+    /// Records an input event. Only the oldest input not yet consumed by a frame is kept.
+    void OnInput(uint64_t now)
+    {
+        uint64_t expected = 0;
+        m_pendingInput.compare_exchange_strong(expected, now, std::memory_order_relaxed);
+    }
+
+    /// Called when the frame samples input; consumes pending input events.
+    void SampleInput(uint64_t now)
+    {
+        m_sampleTime = now;
+        m_frameInput = m_pendingInput.exchange(0, std::memory_order_relaxed);
+    }
+
+    /// Called once Present returned for the frame that last called SampleInput.
+    void OnPresent(uint64_t now)
+    {
+        FrameSample sample;
+        sample.sampleToPresentMs = ToMs(now - m_sampleTime);
+        sample.inputToPresentMs = m_frameInput ? ToMs(now - m_frameInput) : 0.0;
+
+        m_history[m_count % kHistorySize] = sample;
+        ++m_count;
+    }
+
+    /// Most recent frame (zeroed if no frame has been presented yet).
+    FrameSample Last() const
+    {
+        return m_count ? m_history[(m_count - 1) % kHistorySize] : FrameSample{};
+    }
+
+    /// Average over the frames in history that actually consumed input.
+    double AverageInputToPresentMs() const
+    {
+        double sum = 0.0;
+        uint32_t n = 0;
+        const uint64_t size = m_count < kHistorySize ? m_count : kHistorySize;
+        for (uint64_t i = 0; i < size; ++i)
+        {
+            if (m_history[i].inputToPresentMs > 0.0)
+            {
+                sum += m_history[i].inputToPresentMs;
+                ++n;
+            }
+        }
+        return n ? sum / n : 0.0;
+    }
+
+    uint64_t FrameCount() const { return m_count; }
+
+private:
+    double ToMs(uint64_t ticks) const { return static_cast<double>(ticks) * 1000.0 / static_cast<double>(m_ticksPerSecond); }
+
+    uint64_t m_ticksPerSecond;
+    std::atomic<uint64_t> m_pendingInput{ 0 };
+    uint64_t m_sampleTime = 0;
+    uint64_t m_frameInput = 0;
+    std::array<FrameSample, kHistorySize> m_history{};
+    uint64_t m_count = 0;
+};
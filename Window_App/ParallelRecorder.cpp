@@ -0,0 +1,142 @@
+#include "ParallelRecorder.h"
+
+// -----------------------------------------------------------
+// Setup / teardown
+// -----------------------------------------------------------
+ParallelRecorder::~ParallelRecorder()
+{
+    Shutdown();
+}
+
+bool ParallelRecorder::Initialize(ID3D12Device* device, D3D12_COMMAND_LIST_TYPE type, UINT workerCount)
+{
+    m_quit = false;
+
+    if (workerCount == 0)
+        workerCount = std::thread::hardware_concurrency();
+    if (workerCount == 0)
+        workerCount = 1;
+
+    for (UINT i = 0; i < workerCount; ++i)
+    {
+        m_workers.push_back(std::make_unique<Worker>());
+        if (!m_workers.back()->pool.Initialize(device, type))
+            return false;
+    }
+
+    // Worker 0 is whoever calls Record()
+    for (UINT i = 1; i < workerCount; ++i)
+        m_threads.emplace_back(&ParallelRecorder::WorkerMain, this, i);
+
+    return true;
+}
+
+void ParallelRecorder::Shutdown()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_quit = true;
+    }
+    m_startCv.notify_all();
+
+    for (std::thread& t : m_threads)
+        t.join();
+    m_threads.clear();
+    m_workers.clear();
+}
+
+// -----------------------------------------------------------
+// Recording
+// -----------------------------------------------------------
+bool ParallelRecorder::Record(UINT taskCount, const RecordTask& task, UINT64 completedFence,
+    ID3D12PipelineState* initialState, std::vector<ID3D12CommandList*>& outLists)
+{
+    outLists.assign(taskCount, nullptr);
+    if (taskCount == 0) return true;
+
+    m_task = &task;
+    m_taskCount = taskCount;
+    m_completedFence = completedFence;
+    m_initialState = initialState;
+    m_outLists = &outLists;
+    m_nextTask = 0;
+
+    // Wake only as many helpers as there is work for
+    const UINT helpers = static_cast<UINT>(m_threads.size());
+    if (helpers > 0 && taskCount > 1)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_busyWorkers = helpers;
+            ++m_generation;
+        }
+        m_startCv.notify_all();
+    }
+
+    RunTasks(0);
+
+    if (helpers > 0 && taskCount > 1)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_doneCv.wait(lock, [this] { return m_busyWorkers == 0; });
+    }
+
+    m_task = nullptr;
+    m_outLists = nullptr;
+
+    bool ok = true;
+    for (auto& worker : m_workers)
+    {
+        ok = ok && !worker->failed;
+        worker->failed = false;
+    }
+    return ok;
+}
+
+void ParallelRecorder::Retire(UINT64 fenceValue)
+{
+    for (auto& worker : m_workers)
+        worker->pool.ReleaseAll(fenceValue);
+}
+
+void ParallelRecorder::WorkerMain(UINT workerIndex)
+{
+    UINT64 seenGeneration = 0;
+    for (;;)
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_startCv.wait(lock, [&] { return m_quit || m_generation != seenGeneration; });
+            if (m_quit) return;
+            seenGeneration = m_generation;
+        }
+
+        RunTasks(workerIndex);
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            --m_busyWorkers;
+        }
+        m_doneCv.notify_one();
+    }
+}
+
+void ParallelRecorder::RunTasks(UINT workerIndex)
+{
+    Worker& worker = *m_workers[workerIndex];
+
+    for (UINT t = m_nextTask++; t < m_taskCount; t = m_nextTask++)
+    {
+        ID3D12GraphicsCommandList* list = worker.pool.Acquire(m_completedFence, m_initialState);
+        if (!list)
+        {
+            worker.failed = true;
+            continue;
+        }
+
+        (*m_task)(list, t);
+        list->Close();
+
+        (*m_outLists)[t] = list;
+    }
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <windows.h>
+#include <wrl.h>
+#include <d3d12.h>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "CommandListPool.h"
+
+using Microsoft::WRL::ComPtr;
+
+// -----------------------------------------------------------
+// ParallelRecorder
+//   Splits a frame into N recording tasks. Every task gets its own
+//   command list + allocator taken from the CommandListPool of the
+//   thread that records it. Lists come back in task order so they
+//   can go to a single ExecuteCommandLists call.
+//
+//   The calling thread records too, so workerCount == 1 spawns no
+//   threads at all.
+// -----------------------------------------------------------
+class ParallelRecorder
+{
+public:
+    using RecordTask = std::function<void(ID3D12GraphicsCommandList* list, UINT taskIndex)>;
+
+    ParallelRecorder() = default;
+    ~ParallelRecorder();
+
+    ParallelRecorder(const ParallelRecorder&) = delete;
+    ParallelRecorder& operator=(const ParallelRecorder&) = delete;
+
+    /// workerCount == 0 uses every hardware thread.
+    bool Initialize(ID3D12Device* device, D3D12_COMMAND_LIST_TYPE type, UINT workerCount);
+    void Shutdown();
+
+    /// Records taskCount tasks in parallel. completedFence is the fence
+    /// value the GPU has already passed, used to recycle allocators.
+    /// Returns false if a command list could not be created.
+    bool Record(UINT taskCount, const RecordTask& task, UINT64 completedFence,
+        ID3D12PipelineState* initialState, std::vector<ID3D12CommandList*>& outLists);
+
+    /// Tags every list handed out by the last Record() with its submission fence.
+    void Retire(UINT64 fenceValue);
+
+    UINT WorkerCount() const { return static_cast<UINT>(m_workers.size()); }
+
+private:
+    // One pool per recording thread, so its lock is never contended
+    struct Worker
+    {
+        CommandListPool pool;
+        bool failed = false;
+    };
+
+    void WorkerMain(UINT workerIndex);
+    void RunTasks(UINT workerIndex);
+
+private:
+    std::vector<std::unique_ptr<Worker>> m_workers;
+    std::vector<std::thread> m_threads;
+
+    // Current batch (valid while a Record() call is running)
+    const RecordTask* m_task = nullptr;
+    UINT m_taskCount = 0;
+    UINT64 m_completedFence = 0;
+    ID3D12PipelineState* m_initialState = nullptr;
+    std::vector<ID3D12CommandList*>* m_outLists = nullptr;
+    std::atomic<UINT> m_nextTask{ 0 };
+
+    std::mutex m_mutex;
+    std::condition_variable m_startCv;
+    std::condition_variable m_doneCv;
+    UINT64 m_generation = 0;
+    UINT m_busyWorkers = 0;
+    bool m_quit = false;
+};
@@ -1,3 +1,13 @@
+#if BINDLESS
+#include "Bindless.hlsli"
+#endif
+
+// Per-frame constants from the upload ring
+cbuffer FrameConstants : register(b1)
+{
+    float4 g_tint;
+};
+
 struct PSInput
 {
     float4 position : SV_POSITION;
@@ -6,5 +16,11 @@ struct PSInput
 
 float4 PSMain(PSInput input) : SV_TARGET
 {
-    return input.color;
+    float4 color = input.color * g_tint;
+#if BINDLESS
+    // Optional per-draw tint: float4 at the start of a raw buffer
+    if (g_resourceIndex != BINDLESS_INVALID)
+        color *= asfloat(g_buffers[g_resourceIndex].Load4(0));
+#endif
+    return color;
 }
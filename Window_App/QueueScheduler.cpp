@@ -0,0 +1,140 @@
+#include "QueueScheduler.h"
+
+namespace
+{
+    const D3D12_COMMAND_LIST_TYPE kListTypes[] =
+    {
+        D3D12_COMMAND_LIST_TYPE_DIRECT,
+        D3D12_COMMAND_LIST_TYPE_COMPUTE,
+        D3D12_COMMAND_LIST_TYPE_COPY,
+    };
+
+    const wchar_t* const kQueueNames[] =
+    {
+        L"Direct Queue",
+        L"Async Compute Queue",
+        L"Copy Queue",
+    };
+}
+
+// -----------------------------------------------------------
+// Setup / teardown
+// -----------------------------------------------------------
+QueueScheduler::~QueueScheduler()
+{
+    Shutdown();
+}
+
+bool QueueScheduler::Initialize(ID3D12Device* device)
+{
+    for (UINT i = 0; i < kQueueCount; ++i)
+    {
+        D3D12_COMMAND_QUEUE_DESC desc{};
+        desc.Type = kListTypes[i];
+        if (FAILED(device->CreateCommandQueue(&desc, IID_PPV_ARGS(&m_queues[i].queue))))
+            return false;
+        m_queues[i].queue->SetName(kQueueNames[i]);
+
+        if (FAILED(device->CreateFence(0, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&m_queues[i].fence))))
+            return false;
+    }
+    return true;
+}
+
+void QueueScheduler::Shutdown()
+{
+    WaitIdle();
+    for (Queue& q : m_queues)
+    {
+        q.queue.Reset();
+        q.fence.Reset();
+    }
+}
+
+// -----------------------------------------------------------
+// Submission
+// -----------------------------------------------------------
+TimelinePoint QueueScheduler::Submit(QueueType type, UINT listCount, ID3D12CommandList* const* lists,
+    const TimelinePoint* deps, UINT depCount)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    Queue& q = m_queues[Index(type)];
+    InsertWaitsLocked(q, deps, depCount, type);
+
+    if (listCount > 0)
+        q.queue->ExecuteCommandLists(listCount, lists);
+
+    ++q.lastSubmitted;
+    q.queue->Signal(q.fence.Get(), q.lastSubmitted);
+    return { type, q.lastSubmitted };
+}
+
+TimelinePoint QueueScheduler::Signal(QueueType type)
+{
+    return Submit(type, 0, nullptr);
+}
+
+void QueueScheduler::InsertWaitsLocked(Queue& target, const TimelinePoint* deps, UINT depCount, QueueType self)
+{
+    for (UINT i = 0; i < depCount; ++i)
+    {
+        const TimelinePoint& dep = deps[i];
+
+        // Work on the same queue is already ordered
+        if (dep.value == 0 || dep.queue == self)
+            continue;
+
+        const Queue& source = m_queues[Index(dep.queue)];
+        UINT64& waited = target.waitedFor[Index(dep.queue)];
+        if (dep.value <= waited)
+            continue;
+        if (source.fence->GetCompletedValue() >= dep.value)
+            continue;
+
+        target.queue->Wait(source.fence.Get(), dep.value);
+        waited = dep.value;
+    }
+}
+
+// -----------------------------------------------------------
+// Queries / CPU waits
+// -----------------------------------------------------------
+UINT64 QueueScheduler::NextValue(QueueType type) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_queues[Index(type)].lastSubmitted + 1;
+}
+
+UINT64 QueueScheduler::LastSubmitted(QueueType type) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_queues[Index(type)].lastSubmitted;
+}
+
+UINT64 QueueScheduler::CompletedValue(QueueType type) const
+{
+    return m_queues[Index(type)].fence->GetCompletedValue();
+}
+
+bool QueueScheduler::IsComplete(const TimelinePoint& point) const
+{
+    return point.value == 0 || CompletedValue(point.queue) >= point.value;
+}
+
+void QueueScheduler::WaitCpu(const TimelinePoint& point) const
+{
+    if (IsComplete(point)) return;
+
+    // A null event makes SetEventOnCompletion block until the value is reached
+    m_queues[Index(point.queue)].fence->SetEventOnCompletion(point.value, nullptr);
+}
+
+void QueueScheduler::WaitIdle()
+{
+    for (UINT i = 0; i < kQueueCount; ++i)
+    {
+        if (!m_queues[i].fence) continue;
+        WaitCpu({ static_cast<QueueType>(i), LastSubmitted(static_cast<QueueType>(i)) });
+    }
+}
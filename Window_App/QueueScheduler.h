@@ -0,0 +1,86 @@
+#pragma once
+
+#include <windows.h>
+#include <wrl.h>
+#include <d3d12.h>
+#include <mutex>
+
+using Microsoft::WRL::ComPtr;
+
+enum class QueueType : UINT
+{
+    Direct,
+    Compute,
+    Copy,
+    Count
+};
+
+// A value on one queue's timeline fence
+struct TimelinePoint
+{
+    QueueType queue = QueueType::Direct;
+    UINT64 value = 0;   ///< 0 = already satisfied
+};
+
+// -----------------------------------------------------------
+// QueueScheduler
+//   Owns the direct, async compute and copy queues, each with its
+//   own monotonically increasing timeline fence. Work declares the
+//   timeline points it depends on; the scheduler inserts the GPU-side
+//   Wait()s on other queues (skipping ones already satisfied or
+//   already waited for) and Signal()s the submitting queue.
+// -----------------------------------------------------------
+class QueueScheduler
+{
+public:
+    static constexpr UINT kQueueCount = static_cast<UINT>(QueueType::Count);
+
+    QueueScheduler() = default;
+    ~QueueScheduler();
+
+    QueueScheduler(const QueueScheduler&) = delete;
+    QueueScheduler& operator=(const QueueScheduler&) = delete;
+
+    bool Initialize(ID3D12Device* device);
+    void Shutdown();
+
+    ID3D12CommandQueue* GetQueue(QueueType type) const { return m_queues[Index(type)].queue.Get(); }
+
+    /// Executes lists on a queue after every dependency and returns the
+    /// timeline point that marks their completion.
+    TimelinePoint Submit(QueueType type, UINT listCount, ID3D12CommandList* const* lists,
+        const TimelinePoint* deps = nullptr, UINT depCount = 0);
+
+    /// Signals a queue without new work (e.g. after Present).
+    TimelinePoint Signal(QueueType type);
+
+    /// Value the next Submit/Signal on this queue will use.
+    UINT64 NextValue(QueueType type) const;
+    UINT64 LastSubmitted(QueueType type) const;
+    UINT64 CompletedValue(QueueType type) const;
+
+    bool IsComplete(const TimelinePoint& point) const;
+
+    /// Blocks the calling thread until the point has completed.
+    void WaitCpu(const TimelinePoint& point) const;
+
+    /// Flushes every queue.
+    void WaitIdle();
+
+private:
+    struct Queue
+    {
+        ComPtr<ID3D12CommandQueue> queue;
+        ComPtr<ID3D12Fence> fence;
+        UINT64 lastSubmitted = 0;
+        UINT64 waitedFor[kQueueCount]{};   ///< highest value already waited on, per source queue
+    };
+
+    static UINT Index(QueueType type) { return static_cast<UINT>(type); }
+
+    void InsertWaitsLocked(Queue& target, const TimelinePoint* deps, UINT depCount, QueueType self);
+
+private:
+    Queue m_queues[kQueueCount];
+    mutable std::mutex m_mutex;
+};
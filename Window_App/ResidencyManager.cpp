@@ -0,0 +1,114 @@
+#include "ResidencyManager.h"
+
+static_assert(static_cast<UINT>(QueueType::Count) <= ResidencyPolicy::kMaxTimelines,
+    "ResidencyPolicy must track every queue timeline");
+
+namespace
+{
+    UINT64 Now()
+    {
+        LARGE_INTEGER t;
+        QueryPerformanceCounter(&t);
+        return static_cast<UINT64>(t.QuadPart);
+    }
+}
+
+// -----------------------------------------------------------
+// Setup
+// -----------------------------------------------------------
+bool ResidencyManager::Initialize(ID3D12Device* device, IDXGIAdapter1* adapter, double budgetFraction)
+{
+    m_device = device;
+    m_budgetFraction = budgetFraction;
+
+    // Budget queries need DXGI 1.4; without it nothing is ever evicted
+    adapter->QueryInterface(IID_PPV_ARGS(&m_adapter));
+
+    LARGE_INTEGER freq;
+    QueryPerformanceFrequency(&freq);
+    m_qpcFrequency = static_cast<UINT64>(freq.QuadPart);
+    return true;
+}
+
+// -----------------------------------------------------------
+// Objects
+// -----------------------------------------------------------
+UINT32 ResidencyManager::Track(ID3D12Pageable* object, UINT64 size)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    const UINT32 id = m_policy.Add(size);
+    if (id >= m_objects.size()) m_objects.resize(id + 1, nullptr);
+    m_objects[id] = object;
+    return id;
+}
+
+void ResidencyManager::Untrack(UINT32 id)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    m_policy.Remove(id);
+    m_objects[id] = nullptr;
+}
+
+void ResidencyManager::MarkUsed(UINT32 id, const TimelinePoint& point)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (!m_policy.MarkUsed(id, point.value, static_cast<UINT32>(point.queue))) return;
+
+    // Paged out earlier: bring it back before the work that uses it is submitted
+    const UINT64 start = Now();
+    ID3D12Pageable* object = m_objects[id];
+    m_device->MakeResident(1, &object);
+    m_pagingTicks += Now() - start;
+}
+
+// -----------------------------------------------------------
+// Per frame
+// -----------------------------------------------------------
+void ResidencyManager::Update(const QueueScheduler& queues)
+{
+    // A heap is idle only once every queue that touched it is past its last use
+    UINT64 completed[ResidencyPolicy::kMaxTimelines]{};
+    for (UINT q = 0; q < static_cast<UINT>(QueueType::Count); ++q)
+        completed[q] = queues.CompletedValue(static_cast<QueueType>(q));
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (m_adapter)
+    {
+        DXGI_QUERY_VIDEO_MEMORY_INFO info{};
+        if (SUCCEEDED(m_adapter->QueryVideoMemoryInfo(0, DXGI_MEMORY_SEGMENT_GROUP_LOCAL, &info)))
+        {
+            m_stats.budget = info.Budget;
+            m_stats.usage = info.CurrentUsage;
+
+            const UINT64 target = static_cast<UINT64>(info.Budget * m_budgetFraction);
+            m_evictIds.clear();
+            if (m_policy.SelectEvictions(info.CurrentUsage, target, completed, m_evictIds) > 0)
+            {
+                m_evictObjects.clear();
+                for (UINT32 id : m_evictIds)
+                    m_evictObjects.push_back(m_objects[id]);
+
+                const UINT64 start = Now();
+                m_device->Evict(static_cast<UINT>(m_evictObjects.size()), m_evictObjects.data());
+                m_pagingTicks += Now() - start;
+            }
+        }
+    }
+
+    m_stats.lastPagingMs = m_pagingTicks * 1000.0 / m_qpcFrequency;
+    m_stats.totalPagingMs += m_stats.lastPagingMs;
+    m_pagingTicks = 0;
+}
+
+ResidencyManager::Stats ResidencyManager::GetStats() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    Stats s = m_stats;
+    s.policy = m_policy.GetStats();
+    return s;
+}
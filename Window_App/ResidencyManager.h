@@ -0,0 +1,74 @@
+#pragma once
+
+#include <windows.h>
+#include <wrl.h>
+#include <d3d12.h>
+#include <dxgi1_6.h>
+#include <mutex>
+#include <vector>
+
+#include "QueueScheduler.h"
+#include "ResidencyPolicy.h"
+
+using Microsoft::WRL::ComPtr;
+
+// -----------------------------------------------------------
+// ResidencyManager
+//   Keeps local video memory under the budget the OS reports
+//   (IDXGIAdapter3::QueryVideoMemoryInfo) instead of letting the
+//   OS page at an arbitrary point mid-frame.
+//
+//   Heaps are registered with Track(); MarkUsed() records the timeline
+//   point (any queue) of the work that reads or writes them and pages
+//   an evicted heap back in before that work is submitted. Update()
+//   runs once per frame, polls the budget and evicts least-recently-
+//   used heaps no queue is still using (ResidencyPolicy) until usage
+//   fits.
+//
+//   Internally locked.
+// -----------------------------------------------------------
+class ResidencyManager
+{
+public:
+    struct Stats
+    {
+        UINT64 budget = 0;              ///< OS budget for local memory
+        UINT64 usage = 0;               ///< process usage at the last Update()
+        ResidencyPolicy::Stats policy;  ///< tracked / resident bytes, eviction and page-in totals
+        double lastPagingMs = 0.0;      ///< time spent in MakeResident/Evict during the last frame
+        double totalPagingMs = 0.0;
+    };
+
+    ResidencyManager() = default;
+
+    ResidencyManager(const ResidencyManager&) = delete;
+    ResidencyManager& operator=(const ResidencyManager&) = delete;
+
+    /// budgetFraction leaves headroom for allocations made between updates.
+    bool Initialize(ID3D12Device* device, IDXGIAdapter1* adapter, double budgetFraction = 0.9);
+
+    UINT32 Track(ID3D12Pageable* object, UINT64 size);
+    void Untrack(UINT32 id);
+
+    /// Makes the object resident right away if it was evicted.
+    /// A point with value 0 only pages it in (placement, before a copy is queued).
+    void MarkUsed(UINT32 id, const TimelinePoint& point);
+
+    void Update(const QueueScheduler& queues);
+
+    Stats GetStats() const;
+
+private:
+    ID3D12Device* m_device = nullptr;
+    ComPtr<IDXGIAdapter3> m_adapter;
+    double m_budgetFraction = 0.9;
+    UINT64 m_qpcFrequency = 1;
+
+    mutable std::mutex m_mutex;
+    ResidencyPolicy m_policy;
+    std::vector<ID3D12Pageable*> m_objects;     ///< by policy id (not owned)
+    std::vector<UINT32> m_evictIds;
+    std::vector<ID3D12Pageable*> m_evictObjects;
+    UINT64 m_pagingTicks = 0;                   ///< since the last Update()
+    Stats m_stats;
+};
@@ -0,0 +1,133 @@
+#include "ResidencyPolicy.h"
+
+// -----------------------------------------------------------
+// Objects
+// -----------------------------------------------------------
+uint32_t ResidencyPolicy::Add(uint64_t size)
+{
+    uint32_t id;
+    if (!m_freeIds.empty())
+    {
+        id = m_freeIds.back();
+        m_freeIds.pop_back();
+    }
+    else
+    {
+        id = static_cast<uint32_t>(m_entries.size());
+        m_entries.emplace_back();
+    }
+
+    Entry& e = m_entries[id];
+    e = Entry{};
+    e.size = size;
+    e.live = true;
+    e.resident = true;
+    Link(id);
+
+    m_stats.trackedBytes += size;
+    m_stats.residentBytes += size;
+    ++m_stats.objectCount;
+    ++m_stats.residentCount;
+    return id;
+}
+
+void ResidencyPolicy::Remove(uint32_t id)
+{
+    Entry& e = m_entries[id];
+    if (!e.live) return;
+
+    if (e.resident)
+    {
+        Unlink(id);
+        m_stats.residentBytes -= e.size;
+        --m_stats.residentCount;
+    }
+    m_stats.trackedBytes -= e.size;
+    --m_stats.objectCount;
+
+    e.live = false;
+    m_freeIds.push_back(id);
+}
+
+bool ResidencyPolicy::MarkUsed(uint32_t id, uint64_t fenceValue, uint32_t timeline)
+{
+    Entry& e = m_entries[id];
+    if (fenceValue > e.lastUsed[timeline]) e.lastUsed[timeline] = fenceValue;
+
+    if (e.resident)
+    {
+        // Move to the most recently used end
+        Unlink(id);
+        Link(id);
+        return false;
+    }
+
+    e.resident = true;
+    Link(id);
+    m_stats.residentBytes += e.size;
+    ++m_stats.residentCount;
+    ++m_stats.pageIns;
+    m_stats.pagedInBytes += e.size;
+    return true;
+}
+
+// -----------------------------------------------------------
+// Eviction
+// -----------------------------------------------------------
+uint64_t ResidencyPolicy::SelectEvictions(uint64_t usage, uint64_t budget, const uint64_t* completedFences, std::vector<uint32_t>& out)
+{
+    uint64_t freed = 0;
+    uint32_t id = m_head;
+
+    // Oldest first. Queues run independently, so an object still in
+    // use on one of them is skipped rather than ending the search.
+    while (id != kInvalid && usage > budget + freed)
+    {
+        Entry& e = m_entries[id];
+        const uint32_t next = e.next;
+
+        bool busy = false;
+        for (uint32_t t = 0; t < kMaxTimelines; ++t)
+            busy |= e.lastUsed[t] > completedFences[t];
+        if (busy)
+        {
+            id = next;
+            continue;
+        }
+
+        Unlink(id);
+        e.resident = false;
+
+        freed += e.size;
+        m_stats.residentBytes -= e.size;
+        --m_stats.residentCount;
+        ++m_stats.evictions;
+        m_stats.evictedBytes += e.size;
+        out.push_back(id);
+        id = next;
+    }
+    return freed;
+}
+
+// -----------------------------------------------------------
+// LRU list
+// -----------------------------------------------------------
+void ResidencyPolicy::Link(uint32_t id)
+{
+    Entry& e = m_entries[id];
+    e.prev = m_tail;
+    e.next = kInvalid;
+    if (m_tail != kInvalid) m_entries[m_tail].next = id;
+    else m_head = id;
+    m_tail = id;
+}
+
+void ResidencyPolicy::Unlink(uint32_t id)
+{
+    Entry& e = m_entries[id];
+    if (e.prev != kInvalid) m_entries[e.prev].next = e.next;
+    else m_head = e.next;
+    if (e.next != kInvalid) m_entries[e.next].prev = e.prev;
+    else m_tail = e.prev;
+    e.prev = e.next = kInvalid;
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+// -----------------------------------------------------------
+// ResidencyPolicy
+//   LRU bookkeeping for pageable objects (heaps). Every object has
+//   a size and, per queue timeline, the fence value of the last
+//   submit that used it; resident objects are kept in
+//   least-recently-used order.
+//
+//   When the reported usage exceeds the budget, SelectEvictions()
+//   picks the oldest resident objects that every timeline is already
+//   done with until enough bytes are freed. MarkUsed() on an evicted
+//   object reports that it has to be made resident before the work
+//   that uses it runs.
+//
+//   Sizes and fence values only; no device needed, so the policy
+//   can be driven by a simulated budget. Not thread-safe.
+// -----------------------------------------------------------
+class ResidencyPolicy
+{
+public:
+    static constexpr uint32_t kInvalid = 0xFFFFFFFFu;
+    static constexpr uint32_t kMaxTimelines = 4;    ///< queues whose fences are tracked
+
+    struct Stats
+    {
+        uint64_t trackedBytes = 0;
+        uint64_t residentBytes = 0;
+        uint32_t objectCount = 0;
+        uint32_t residentCount = 0;
+        uint64_t evictions = 0;         ///< total objects evicted
+        uint64_t evictedBytes = 0;      ///< total bytes evicted
+        uint64_t pageIns = 0;           ///< total objects made resident again
+        uint64_t pagedInBytes = 0;      ///< total bytes made resident again
+    };
+
+    /// New objects are resident and most recently used.
+    uint32_t Add(uint64_t size);
+    void Remove(uint32_t id);
+
+    /// Returns true if the object was evicted and must be made resident.
+    /// fenceValue 0 only touches the object (resident, most recently used).
+    bool MarkUsed(uint32_t id, uint64_t fenceValue, uint32_t timeline = 0);
+
+    /// Appends the objects to evict so that usage drops to the budget.
+    /// Only objects whose last use on every timeline is at or before
+    /// completedFences[timeline] (kMaxTimelines entries) are candidates.
+    /// Returns the number of bytes selected.
+    uint64_t SelectEvictions(uint64_t usage, uint64_t budget, const uint64_t* completedFences, std::vector<uint32_t>& out);
+
+    bool IsResident(uint32_t id) const { return m_entries[id].resident; }
+    uint64_t Size(uint32_t id) const { return m_entries[id].size; }
+    uint64_t LastUsed(uint32_t id, uint32_t timeline = 0) const { return m_entries[id].lastUsed[timeline]; }
+
+    const Stats& GetStats() const { return m_stats; }
+
+private:
+    struct Entry
+    {
+        uint64_t size = 0;
+        uint64_t lastUsed[kMaxTimelines]{};
+        uint32_t prev = kInvalid;   ///< LRU list (resident objects only)
+        uint32_t next = kInvalid;
+        bool resident = false;
+        bool live = false;
+    };
+
+    void Link(uint32_t id);     ///< append as most recently used
+    void Unlink(uint32_t id);
+
+private:
+    std::vector<Entry> m_entries;
+    std::vector<uint32_t> m_freeIds;
+    uint32_t m_head = kInvalid;     ///< least recently used
+    uint32_t m_tail = kInvalid;     ///< most recently used
+    Stats m_stats;
+};
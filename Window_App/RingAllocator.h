@@ -0,0 +1,100 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+
+// -----------------------------------------------------------
+// RingAllocator
+//   Bump-pointer suballocation out of a fixed-size ring, reclaimed
+//   by fence value. Everything allocated between two Seal() calls
+//   (typically one frame) is released together once the GPU has
+//   passed the fence value given to Seal().
+//
+//   Offsets only; the allocator never touches memory, so it can be
+//   tested without a device. Not thread-safe.
+// -----------------------------------------------------------
+class RingAllocator
+{
+public:
+    static constexpr uint64_t kInvalidOffset = ~0ull;
+
+    explicit RingAllocator(uint64_t capacity = 0) { Reset(capacity); }
+
+    /// Drops every allocation. Capacity should be a multiple of the largest alignment used.
+    void Reset(uint64_t capacity)
+    {
+        m_capacity = capacity;
+        m_head = 0;
+        m_tail = 0;
+        m_sealedHead = 0;
+        m_sealed.clear();
+    }
+
+    /// Returns the offset of `size` bytes aligned to `alignment` (power of two),
+    /// or kInvalidOffset if the ring is full.
+    uint64_t Allocate(uint64_t size, uint64_t alignment = 1)
+    {
+        if (size == 0 || size > m_capacity) return kInvalidOffset;
+
+        uint64_t head = m_head;
+        uint64_t offset = AlignUp(head % m_capacity, alignment);
+
+        // Never straddle the end of the ring: skip the remainder and start over at 0
+        if (offset + size > m_capacity)
+        {
+            head += m_capacity - head % m_capacity;
+            offset = 0;
+        }
+        else
+        {
+            head += offset - head % m_capacity;
+        }
+
+        if (head + size - m_tail > m_capacity)
+            return kInvalidOffset;
+
+        m_head = head + size;
+        return offset;
+    }
+
+    /// Closes the current batch; it is reclaimed once fenceValue has completed.
+    void Seal(uint64_t fenceValue)
+    {
+        if (m_head == m_sealedHead) return;
+        m_sealed.push_back({ m_head, fenceValue });
+        m_sealedHead = m_head;
+    }
+
+    /// Releases every sealed batch whose fence value has completed.
+    void Reclaim(uint64_t completedFence)
+    {
+        while (!m_sealed.empty() && m_sealed.front().fenceValue <= completedFence)
+        {
+            m_tail = m_sealed.front().end;
+            m_sealed.pop_front();
+        }
+    }
+
+    uint64_t Capacity() const { return m_capacity; }
+    uint64_t UsedBytes() const { return m_head - m_tail; }     ///< including alignment / wrap padding
+    uint64_t FreeBytes() const { return m_capacity - UsedBytes(); }
+
+private:
+    static uint64_t AlignUp(uint64_t value, uint64_t alignment)
+    {
+        return (value + alignment - 1) & ~(alignment - 1);
+    }
+
+    struct Batch
+    {
+        uint64_t end;           ///< monotonic head at Seal()
+        uint64_t fenceValue;
+    };
+
+private:
+    uint64_t m_capacity = 0;
+    uint64_t m_head = 0;        ///< monotonic write position
+    uint64_t m_tail = 0;        ///< monotonic start of the oldest live batch
+    uint64_t m_sealedHead = 0;  ///< head at the last Seal()
+    std::deque<Batch> m_sealed;
+};
@@ -0,0 +1,41 @@
+#include "TestFramework.h"
+#include "DescriptorFreeList.h"
+
+TEST(DescriptorFreeList_NeedsAPage)
+{
+    DescriptorFreeList slots(4);
+    CHECK(slots.Allocate() == DescriptorFreeList::kInvalid);
+
+    CHECK(slots.AddPage() == 0);
+    CHECK(slots.Capacity() == 4);
+    for (uint32_t i = 0; i < 4; ++i)
+        CHECK(slots.Allocate() == i);
+    CHECK(slots.Allocate() == DescriptorFreeList::kInvalid);
+    CHECK(slots.UsedCount() == 4);
+}
+
+TEST(DescriptorFreeList_ReusesFreedSlotsFirst)
+{
+    DescriptorFreeList slots(4);
+    slots.AddPage();
+    slots.Allocate();
+    const uint32_t b = slots.Allocate();
+    CHECK(slots.Free(b));
+    CHECK(slots.Allocate() == b);
+
+    // Freeing twice, or a slot that was never handed out, is refused
+    CHECK(slots.Free(b));
+    CHECK(!slots.Free(b));
+    CHECK(!slots.Free(100));
+}
+
+TEST(DescriptorFreeList_PageAndIndex)
+{
+    DescriptorFreeList slots(4);
+    slots.AddPage();
+    CHECK(slots.AddPage() == 1);
+    CHECK(slots.PageOf(5) == 1);
+    CHECK(slots.IndexInPage(5) == 1);
+    CHECK(slots.PageCount() == 2);
+    CHECK(slots.FreeCount() == 8);
+}
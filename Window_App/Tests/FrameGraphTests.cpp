@@ -0,0 +1,179 @@
+#include "TestFramework.h"
+#include "FrameGraph.h"
+
+namespace
+{
+    FrameGraph::TransientDesc Transient(uint64_t size)
+    {
+        FrameGraph::TransientDesc desc;
+        desc.desc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+        desc.desc.Width = size;
+        desc.sizeInBytes = size;
+        return desc;
+    }
+
+    void NoOp(FrameGraph::PassContext&) {}
+
+    size_t CountTransitions(const std::vector<FrameGraph::Barrier>& barriers, FrameGraph::ResourceHandle resource)
+    {
+        size_t count = 0;
+        for (const FrameGraph::Barrier& b : barriers)
+            if (b.type == FrameGraph::Barrier::Type::Transition && b.resource == resource)
+                ++count;
+        return count;
+    }
+}
+
+TEST(FrameGraph_CullsUnconsumedPasses)
+{
+    FrameGraph graph;
+    const FrameGraph::ResourceHandle backBuffer = graph.Import("back buffer", nullptr,
+        D3D12_RESOURCE_STATE_PRESENT, D3D12_RESOURCE_STATE_PRESENT);
+    const FrameGraph::ResourceHandle used = graph.CreateTransient("used", Transient(64 * 1024));
+    const FrameGraph::ResourceHandle unused = graph.CreateTransient("unused", Transient(64 * 1024));
+
+    const FrameGraph::PassHandle producer = graph.AddPass("producer", NoOp);
+    graph.Write(producer, used, D3D12_RESOURCE_STATE_RENDER_TARGET);
+    const FrameGraph::PassHandle orphan = graph.AddPass("orphan", NoOp);
+    graph.Write(orphan, unused, D3D12_RESOURCE_STATE_RENDER_TARGET);
+    const FrameGraph::PassHandle composite = graph.AddPass("composite", NoOp);
+    graph.Read(composite, used, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+    graph.Write(composite, backBuffer, D3D12_RESOURCE_STATE_RENDER_TARGET);
+
+    const FrameGraph::Compiled& c = graph.Compile();
+    CHECK(!c.culled[producer]);
+    CHECK(c.culled[orphan]);
+    CHECK(!c.culled[composite]);
+    CHECK(c.passes.size() == 2);
+    CHECK(c.passes[0].pass == producer);
+    CHECK(c.passes[1].pass == composite);
+
+    // A culled pass gives its transient no lifetime at all
+    CHECK(c.firstPass[unused] == FrameGraph::kInvalid);
+
+    // Side effects keep a pass alive without any consumer
+    FrameGraph sideEffects;
+    const FrameGraph::ResourceHandle scratch = sideEffects.CreateTransient("scratch", Transient(256));
+    const FrameGraph::PassHandle readback = sideEffects.AddPass("readback", NoOp);
+    sideEffects.Write(readback, scratch, D3D12_RESOURCE_STATE_COPY_DEST);
+    sideEffects.SetSideEffect(readback);
+    CHECK(!sideEffects.Compile().culled[readback]);
+}
+
+TEST(FrameGraph_BatchesTransitionsPerPass)
+{
+    FrameGraph graph;
+    const FrameGraph::ResourceHandle backBuffer = graph.Import("back buffer", nullptr,
+        D3D12_RESOURCE_STATE_PRESENT, D3D12_RESOURCE_STATE_PRESENT);
+    const FrameGraph::ResourceHandle albedo = graph.Import("albedo", nullptr,
+        D3D12_RESOURCE_STATE_COPY_DEST, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+    const FrameGraph::ResourceHandle normals = graph.Import("normals", nullptr,
+        D3D12_RESOURCE_STATE_COPY_DEST, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+
+    const FrameGraph::PassHandle shade = graph.AddPass("shade", NoOp);
+    graph.Read(shade, albedo, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+    graph.Read(shade, normals, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+    graph.Write(shade, backBuffer, D3D12_RESOURCE_STATE_RENDER_TARGET);
+
+    // A second access to the same resource in one pass merges into its barrier
+    graph.Read(shade, albedo, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE);
+
+    const FrameGraph::Compiled& c = graph.Compile();
+    CHECK(c.passes.size() == 1);
+
+    // All three state changes land in the one batch issued before the pass
+    const std::vector<FrameGraph::Barrier>& barriers = c.passes[0].barriers;
+    CHECK(barriers.size() == 3);
+    CHECK(CountTransitions(barriers, backBuffer) == 1);
+    CHECK(CountTransitions(barriers, albedo) == 1);
+    CHECK(CountTransitions(barriers, normals) == 1);
+    for (const FrameGraph::Barrier& b : barriers)
+    {
+        if (b.resource != albedo) continue;
+        CHECK(b.before == D3D12_RESOURCE_STATE_COPY_DEST);
+        CHECK(b.after == (D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE | D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE));
+    }
+}
+
+TEST(FrameGraph_AliasesDisjointTransients)
+{
+    FrameGraph graph;
+    const FrameGraph::ResourceHandle backBuffer = graph.Import("back buffer", nullptr,
+        D3D12_RESOURCE_STATE_PRESENT, D3D12_RESOURCE_STATE_PRESENT);
+    const FrameGraph::ResourceHandle a = graph.CreateTransient("a", Transient(1 << 20));
+    const FrameGraph::ResourceHandle b = graph.CreateTransient("b", Transient(1 << 20));
+    const FrameGraph::ResourceHandle c = graph.CreateTransient("c", Transient(1 << 20));
+
+    // a lives in passes 0-1, b in 1-2, c in 2-3: a and c never overlap
+    const FrameGraph::PassHandle p0 = graph.AddPass("p0", NoOp);
+    graph.Write(p0, a, D3D12_RESOURCE_STATE_RENDER_TARGET);
+    const FrameGraph::PassHandle p1 = graph.AddPass("p1", NoOp);
+    graph.Read(p1, a, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+    graph.Write(p1, b, D3D12_RESOURCE_STATE_RENDER_TARGET);
+    const FrameGraph::PassHandle p2 = graph.AddPass("p2", NoOp);
+    graph.Read(p2, b, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+    graph.Write(p2, c, D3D12_RESOURCE_STATE_RENDER_TARGET);
+    const FrameGraph::PassHandle p3 = graph.AddPass("p3", NoOp);
+    graph.Read(p3, c, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+    graph.Write(p3, backBuffer, D3D12_RESOURCE_STATE_RENDER_TARGET);
+
+    const FrameGraph::Compiled& compiled = graph.Compile();
+    CHECK(compiled.passes.size() == 4);
+    CHECK(compiled.heapOffsets[a] == compiled.heapOffsets[c]);
+    CHECK(compiled.heapOffsets[a] != compiled.heapOffsets[b]);
+    CHECK(compiled.transientHeapSize == 2 << 20);
+
+    // c takes over a's memory behind an aliasing barrier
+    bool aliasing = false;
+    for (const FrameGraph::Barrier& barrier : compiled.passes[2].barriers)
+        if (barrier.type == FrameGraph::Barrier::Type::Aliasing && barrier.resource == c)
+            aliasing = barrier.aliasBefore == a;
+    CHECK(aliasing);
+
+    // Created in the state of their first use, so no transition there
+    CHECK(compiled.createStates[a] == D3D12_RESOURCE_STATE_RENDER_TARGET);
+    CHECK(CountTransitions(compiled.passes[0].barriers, a) == 0);
+}
+
+TEST(FrameGraph_ImportsReturnToFinalState)
+{
+    FrameGraph graph;
+    const FrameGraph::ResourceHandle backBuffer = graph.Import("back buffer", nullptr,
+        D3D12_RESOURCE_STATE_PRESENT, D3D12_RESOURCE_STATE_PRESENT);
+    const FrameGraph::ResourceHandle history = graph.Import("history", nullptr,
+        D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+
+    const FrameGraph::PassHandle scene = graph.AddPass("scene", NoOp);
+    graph.Write(scene, backBuffer, D3D12_RESOURCE_STATE_RENDER_TARGET);
+    const FrameGraph::PassHandle copy = graph.AddPass("copy", NoOp);
+    graph.Read(copy, backBuffer, D3D12_RESOURCE_STATE_COPY_SOURCE);
+    graph.Write(copy, history, D3D12_RESOURCE_STATE_COPY_DEST);
+
+    const FrameGraph::Compiled& c = graph.Compile();
+    CHECK(c.passes.size() == 2);
+
+    CHECK(c.finalBarriers.size() == 2);
+    for (const FrameGraph::Barrier& b : c.finalBarriers)
+    {
+        CHECK(b.type == FrameGraph::Barrier::Type::Transition);
+        if (b.resource == backBuffer)
+        {
+            CHECK(b.before == D3D12_RESOURCE_STATE_COPY_SOURCE);
+            CHECK(b.after == D3D12_RESOURCE_STATE_PRESENT);
+        }
+        else
+        {
+            CHECK(b.resource == history);
+            CHECK(b.before == D3D12_RESOURCE_STATE_COPY_DEST);
+            CHECK(b.after == D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+        }
+    }
+
+    // Nothing to restore when the last state already is the final one
+    FrameGraph settled;
+    const FrameGraph::ResourceHandle target = settled.Import("target", nullptr,
+        D3D12_RESOURCE_STATE_RENDER_TARGET, D3D12_RESOURCE_STATE_RENDER_TARGET);
+    const FrameGraph::PassHandle draw = settled.AddPass("draw", NoOp);
+    settled.Write(draw, target, D3D12_RESOURCE_STATE_RENDER_TARGET);
+    CHECK(settled.Compile().finalBarriers.empty());
+}
@@ -0,0 +1,100 @@
+#include "TestFramework.h"
+#include "FrameRing.h"
+
+namespace
+{
+    // GPU stand-in: completes nothing on its own; a wait "runs" the
+    // GPU up to the requested value
+    struct MockFence
+    {
+        uint64_t completed = 0;
+        uint64_t waits = 0;
+        uint64_t lastWaitValue = 0;
+
+        uint64_t GetCompletedValue() const { return completed; }
+        void WaitForValue(uint64_t value)
+        {
+            ++waits;
+            lastWaitValue = value;
+            if (completed < value) completed = value;
+        }
+    };
+
+    struct Context
+    {
+        uint32_t uses = 0;
+    };
+}
+
+TEST(FrameRing_DepthIsClamped)
+{
+    FrameRing<Context, 4> ring(1);
+    CHECK(ring.FrameCount() == 2);
+    ring.Resize(9);
+    CHECK(ring.FrameCount() == 4);
+    ring.Resize(3);
+    CHECK(ring.FrameCount() == 3);
+}
+
+TEST(FrameRing_WaitsOnlyWhenFull)
+{
+    MockFence fence;
+    FrameRing<Context, 4> ring(3);
+
+    // GPU stalled: three frames can be recorded without waiting
+    for (uint64_t frame = 1; frame <= 3; ++frame)
+    {
+        ring.BeginFrame(fence);
+        ring.EndFrame(frame);
+    }
+    CHECK(fence.waits == 0);
+    CHECK(ring.WaitCount() == 0);
+
+    // The fourth needs slot 0 back, i.e. frame 1 retired
+    ring.BeginFrame(fence);
+    CHECK(fence.waits == 1);
+    CHECK(fence.lastWaitValue == 1);
+    CHECK(ring.WaitCount() == 1);
+}
+
+TEST(FrameRing_NoWaitWhileGpuKeepsUp)
+{
+    MockFence fence;
+    FrameRing<Context, 4> ring(3);
+
+    // GPU two frames behind the CPU: never blocks with three slots
+    for (uint64_t frame = 1; frame <= 100; ++frame)
+    {
+        fence.completed = frame > 2 ? frame - 2 : 0;
+        ring.BeginFrame(fence);
+        ring.EndFrame(frame);
+    }
+    CHECK(fence.waits == 0);
+}
+
+TEST(FrameRing_SlotReusedAfterItsFence)
+{
+    MockFence fence;
+    FrameRing<Context, 4> ring(2);
+
+    Context& first = ring.BeginFrame(fence);
+    ++first.uses;
+    ring.EndFrame(1);
+    ring.BeginFrame(fence);
+    ring.EndFrame(2);
+
+    // Frame 1 done, frame 2 still running: slot 0 comes back without a wait
+    fence.completed = 1;
+    CHECK(ring.CurrentIndex() == 0);
+    Context& again = ring.BeginFrame(fence);
+    CHECK(&again == &first);
+    CHECK(again.uses == 1);
+    CHECK(fence.waits == 0);
+    ring.EndFrame(3);
+
+    // Slot 1 still holds frame 2
+    ring.BeginFrame(fence);
+    CHECK(fence.waits == 1);
+    CHECK(fence.lastWaitValue == 2);
+    CHECK(ring.LastSignaledValue() == 3);
+}
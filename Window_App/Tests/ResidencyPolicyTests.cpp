@@ -0,0 +1,109 @@
+#include "TestFramework.h"
+#include "ResidencyPolicy.h"
+
+namespace
+{
+    // Direct, compute, copy
+    constexpr uint32_t kDirect = 0;
+    constexpr uint32_t kCopy = 2;
+
+    struct Completed
+    {
+        uint64_t values[ResidencyPolicy::kMaxTimelines]{};
+    };
+}
+
+TEST(ResidencyPolicy_EvictsLeastRecentlyUsed)
+{
+    ResidencyPolicy policy;
+    const uint32_t a = policy.Add(100);
+    const uint32_t b = policy.Add(100);
+    const uint32_t c = policy.Add(100);
+    policy.MarkUsed(a, 5, kDirect);
+
+    Completed done;
+    done.values[kDirect] = 10;
+    std::vector<uint32_t> out;
+    CHECK(policy.SelectEvictions(300, 150, done.values, out) == 200);
+    CHECK(out.size() == 2);
+    CHECK(out[0] == b);
+    CHECK(out[1] == c);
+    CHECK(policy.IsResident(a));
+    CHECK(!policy.IsResident(b));
+    CHECK(policy.GetStats().residentBytes == 100);
+    CHECK(policy.GetStats().evictions == 2);
+}
+
+TEST(ResidencyPolicy_NothingEvictedUnderBudget)
+{
+    ResidencyPolicy policy;
+    policy.Add(100);
+
+    Completed done;
+    std::vector<uint32_t> out;
+    CHECK(policy.SelectEvictions(100, 200, done.values, out) == 0);
+    CHECK(out.empty());
+}
+
+TEST(ResidencyPolicy_BusyOnAnyQueueIsKept)
+{
+    ResidencyPolicy policy;
+    const uint32_t x = policy.Add(100);
+    const uint32_t y = policy.Add(100);
+
+    // x is older on the direct queue but the copy queue still writes it
+    policy.MarkUsed(x, 3, kDirect);
+    policy.MarkUsed(x, 7, kCopy);
+    policy.MarkUsed(y, 4, kDirect);
+    CHECK(policy.LastUsed(x, kCopy) == 7);
+
+    Completed done;
+    done.values[kDirect] = 10;
+    done.values[kCopy] = 5;
+    std::vector<uint32_t> out;
+    policy.SelectEvictions(200, 100, done.values, out);
+    CHECK(out.size() == 1);
+    CHECK(out[0] == y);
+    CHECK(policy.IsResident(x));
+
+    // Once the copy is done x can go too
+    done.values[kCopy] = 7;
+    out.clear();
+    policy.SelectEvictions(100, 0, done.values, out);
+    CHECK(out.size() == 1);
+    CHECK(out[0] == x);
+}
+
+TEST(ResidencyPolicy_MarkUsedPagesIn)
+{
+    ResidencyPolicy policy;
+    const uint32_t a = policy.Add(64);
+
+    Completed done;
+    std::vector<uint32_t> out;
+    policy.SelectEvictions(64, 0, done.values, out);
+    CHECK(!policy.IsResident(a));
+
+    // A touch (fence 0) pages it in without recording a use
+    CHECK(policy.MarkUsed(a, 0, kCopy));
+    CHECK(policy.IsResident(a));
+    CHECK(policy.LastUsed(a, kCopy) == 0);
+    CHECK(!policy.MarkUsed(a, 2, kDirect));
+    CHECK(policy.GetStats().pageIns == 1);
+    CHECK(policy.GetStats().pagedInBytes == 64);
+}
+
+TEST(ResidencyPolicy_RemoveUpdatesTotals)
+{
+    ResidencyPolicy policy;
+    const uint32_t a = policy.Add(10);
+    policy.Add(20);
+    policy.Remove(a);
+    policy.Remove(a);
+    CHECK(policy.GetStats().objectCount == 1);
+    CHECK(policy.GetStats().trackedBytes == 20);
+    CHECK(policy.GetStats().residentBytes == 20);
+
+    // The id is reused
+    CHECK(policy.Add(30) == a);
+}
@@ -0,0 +1,55 @@
+#include "TestFramework.h"
+#include "RingAllocator.h"
+
+TEST(RingAllocator_AllocatesAligned)
+{
+    RingAllocator ring(1024);
+    CHECK(ring.Allocate(10) == 0);
+    CHECK(ring.Allocate(10, 256) == 256);
+    CHECK(ring.UsedBytes() == 266);
+
+    CHECK(ring.Allocate(0) == RingAllocator::kInvalidOffset);
+    CHECK(ring.Allocate(2048) == RingAllocator::kInvalidOffset);
+}
+
+TEST(RingAllocator_FullUntilReclaimed)
+{
+    RingAllocator ring(1024);
+    CHECK(ring.Allocate(512) == 0);
+    ring.Seal(1);
+    CHECK(ring.Allocate(512) == 512);
+    ring.Seal(2);
+    CHECK(ring.Allocate(1) == RingAllocator::kInvalidOffset);
+
+    // Frame 1 done: its half of the ring comes back
+    ring.Reclaim(1);
+    CHECK(ring.FreeBytes() == 512);
+    CHECK(ring.Allocate(256) == 0);
+
+    ring.Reclaim(0);
+    CHECK(ring.UsedBytes() == 768);
+}
+
+TEST(RingAllocator_NeverStraddlesTheEnd)
+{
+    RingAllocator ring(1024);
+    CHECK(ring.Allocate(768) == 0);
+    ring.Seal(1);
+    ring.Reclaim(1);
+
+    // 256 bytes remain at the end; 512 wraps to 0 and the remainder is skipped
+    CHECK(ring.Allocate(512) == 0);
+    CHECK(ring.UsedBytes() == 768);
+}
+
+TEST(RingAllocator_EmptySealIsIgnored)
+{
+    RingAllocator ring(256);
+    ring.Seal(1);
+    CHECK(ring.Allocate(256) == 0);
+    ring.Seal(2);
+    ring.Reclaim(1);
+    CHECK(ring.FreeBytes() == 0);
+    ring.Reclaim(2);
+    CHECK(ring.FreeBytes() == 256);
+}
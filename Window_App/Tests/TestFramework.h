@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstdio>
+#include <vector>
+
+// -----------------------------------------------------------
+// Minimal test runner for the headless (no device) cores.
+//   TEST(Name) { ... } registers a test; CHECK(expr) records a
+//   failure and keeps going. TestMain.cpp runs every test and
+//   returns non-zero if any check failed.
+// -----------------------------------------------------------
+using TestFunction = void (*)();
+
+struct TestCase
+{
+    const char* name;
+    TestFunction function;
+};
+
+std::vector<TestCase>& TestRegistry();
+int& TestFailureCount();
+
+struct TestRegistrar
+{
+    TestRegistrar(const char* name, TestFunction function) { TestRegistry().push_back({ name, function }); }
+};
+
+#define TEST(name) \
+    static void name(); \
+    static TestRegistrar name##Registrar(#name, &name); \
+    static void name()
+
+#define CHECK(expr) \
+    do \
+    { \
+        if (!(expr)) \
+        { \
+            ++TestFailureCount(); \
+            std::printf("  %s(%d): CHECK(%s) failed\n", __FILE__, __LINE__, #expr); \
+        } \
+    } while (0)
@@ -0,0 +1,30 @@
+#include "TestFramework.h"
+
+std::vector<TestCase>& TestRegistry()
+{
+    static std::vector<TestCase> registry;
+    return registry;
+}
+
+int& TestFailureCount()
+{
+    static int failures = 0;
+    return failures;
+}
+
+int main()
+{
+    int failedTests = 0;
+    for (const TestCase& test : TestRegistry())
+    {
+        const int before = TestFailureCount();
+        test.function();
+        const bool passed = TestFailureCount() == before;
+        if (!passed) ++failedTests;
+        std::printf("[%s] %s\n", passed ? "PASS" : "FAIL", test.name);
+    }
+
+    std::printf("%d / %d tests passed\n",
+        static_cast<int>(TestRegistry().size()) - failedTests, static_cast<int>(TestRegistry().size()));
+    return failedTests == 0 ? 0 : 1;
+}
@@ -0,0 +1,229 @@
+#include "TestFramework.h"
+#include "TileManager.h"
+
+#include <algorithm>
+
+namespace
+{
+    // mip 0: 2x1 tiles, mip 1: 1x1, packed: 1 tile -> levels 0, 1, 2
+    TileManager::TextureLayout ThreeLevels()
+    {
+        TileManager::TextureLayout layout;
+        layout.mips = { { 2, 1 }, { 1, 1 } };
+        layout.packedTiles = 1;
+        return layout;
+    }
+
+    // mip 0: 2x1 tiles, packed: 1 tile -> levels 0, 1
+    TileManager::TextureLayout TwoLevels()
+    {
+        TileManager::TextureLayout layout;
+        layout.mips = { { 2, 1 } };
+        layout.packedTiles = 1;
+        return layout;
+    }
+
+    std::vector<TileManager::Tile> TilesOfLevel(const TileManager::Plan& plan, uint32_t texture, uint32_t level)
+    {
+        std::vector<TileManager::Tile> tiles;
+        for (const TileManager::Tile& tile : plan.map)
+            if (tile.texture == texture && tile.level == level)
+                tiles.push_back(tile);
+        return tiles;
+    }
+
+    bool Contains(const std::vector<uint32_t>& ids, uint32_t id)
+    {
+        return std::find(ids.begin(), ids.end(), id) != ids.end();
+    }
+}
+
+TEST(TileManager_PackedLevelLoadsFirst)
+{
+    TileManager tiles(8);
+    const uint32_t tex = tiles.AddTexture(ThreeLevels());
+    CHECK(tiles.ResidentMip(tex) == TileManager::kInvalid);
+
+    // Nothing requested: only the packed level is mapped
+    TileManager::Plan plan;
+    tiles.Update(1, 0, 16, plan);
+    CHECK(plan.map.size() == 1);
+    CHECK(tiles.IsPackedLevel(tex, plan.map[0].level));
+    CHECK(tiles.ResidentMip(tex) == TileManager::kInvalid);
+
+    std::vector<uint32_t> changed;
+    tiles.OnTilesLoaded(plan.map, changed);
+    CHECK(Contains(changed, tex));
+    CHECK(tiles.ResidentMip(tex) == 2);
+    CHECK(tiles.GetStats().residentTiles == 1);
+}
+
+TEST(TileManager_ResidentMipWaitsForCoarserLevels)
+{
+    TileManager tiles(8);
+    const uint32_t tex = tiles.AddTexture(ThreeLevels());
+
+    TileManager::Plan plan;
+    std::vector<uint32_t> changed;
+    tiles.Update(1, 0, 16, plan);
+    tiles.OnTilesLoaded(plan.map, changed);
+
+    // Both finer levels are mapped in one plan (coarser one first)
+    tiles.Request(tex, 0, 2);
+    tiles.Update(2, 1, 16, plan);
+    const std::vector<TileManager::Tile> level0 = TilesOfLevel(plan, tex, 0);
+    const std::vector<TileManager::Tile> level1 = TilesOfLevel(plan, tex, 1);
+    CHECK(level0.size() == 2);
+    CHECK(level1.size() == 1);
+
+    // Mip 0 landing first must not be exposed while mip 1 is missing
+    changed.clear();
+    tiles.OnTilesLoaded(level0, changed);
+    CHECK(tiles.ResidentMip(tex) == 2);
+    CHECK(!Contains(changed, tex));
+
+    tiles.OnTilesLoaded(level1, changed);
+    CHECK(tiles.ResidentMip(tex) == 0);
+    CHECK(Contains(changed, tex));
+}
+
+TEST(TileManager_TileBudgetLimitsMaps)
+{
+    TileManager tiles(8);
+    const uint32_t tex = tiles.AddTexture(ThreeLevels());
+
+    TileManager::Plan plan;
+    std::vector<uint32_t> changed;
+    tiles.Update(1, 0, 16, plan);
+    tiles.OnTilesLoaded(plan.map, changed);
+
+    tiles.Request(tex, 0, 2);
+    tiles.Update(2, 1, 2, plan);
+    CHECK(plan.map.size() == 2);
+    tiles.Update(3, 2, 2, plan);
+    CHECK(plan.map.size() == 1);
+    CHECK(tiles.GetStats().loadingTiles == 3);
+}
+
+TEST(TileManager_UnwantedLevelsRetireAfterFence)
+{
+    TileManager tiles(8);
+    tiles.SetEvictDelay(2);
+    const uint32_t tex = tiles.AddTexture(ThreeLevels());
+
+    TileManager::Plan plan;
+    std::vector<uint32_t> changed;
+    tiles.Update(1, 0, 16, plan);
+    tiles.OnTilesLoaded(plan.map, changed);
+    tiles.Request(tex, 0, 2);
+    tiles.Update(2, 1, 16, plan);
+    tiles.OnTilesLoaded(plan.map, changed);
+    CHECK(tiles.ResidentMip(tex) == 0);
+
+    // Not requested since frame 2: both finer levels go; the packed level stays
+    tiles.Update(5, 4, 16, plan);
+    CHECK(Contains(plan.changed, tex));
+    CHECK(tiles.ResidentMip(tex) == 2);
+    CHECK(plan.unmap.empty());
+    CHECK(tiles.GetStats().retiringTiles == 3);
+    CHECK(tiles.GetStats().residentTiles == 1);
+    CHECK(tiles.GetStats().tilesEvicted == 3);
+
+    // Frame 5 may still sample them: nothing comes back before it completes
+    tiles.Update(6, 4, 16, plan);
+    CHECK(plan.unmap.empty());
+    CHECK(tiles.GetStats().freeTiles == 4);
+
+    tiles.Update(7, 5, 16, plan);
+    CHECK(plan.unmap.size() == 3);
+    CHECK(tiles.GetStats().retiringTiles == 0);
+    CHECK(tiles.GetStats().freeTiles == 7);
+}
+
+TEST(TileManager_EvictsLeastRecentlyWantedWhenPoolIsFull)
+{
+    // Room for both packed levels, mip 0 of one texture, and one tile more
+    TileManager tiles(5);
+    const uint32_t a = tiles.AddTexture(TwoLevels());
+    const uint32_t b = tiles.AddTexture(TwoLevels());
+
+    TileManager::Plan plan;
+    std::vector<uint32_t> changed;
+    tiles.Update(1, 0, 16, plan);
+    CHECK(plan.map.size() == 2);
+    tiles.OnTilesLoaded(plan.map, changed);
+
+    tiles.Request(a, 0, 2);
+    tiles.Update(2, 1, 16, plan);
+    tiles.OnTilesLoaded(plan.map, changed);
+    CHECK(tiles.ResidentMip(a) == 0);
+
+    // b wants mip 0 much later; only one tile is free
+    tiles.Request(b, 0, 10);
+    tiles.Update(10, 9, 16, plan);
+    CHECK(TilesOfLevel(plan, b, 0).size() == 1);
+    CHECK(tiles.GetStats().freeTiles == 0);
+
+    // The pool is full: a's mip 0 (last wanted at 2) makes room
+    tiles.Request(b, 0, 11);
+    tiles.Update(11, 10, 16, plan);
+    CHECK(tiles.ResidentMip(a) == 1);
+    CHECK(Contains(plan.changed, a));
+    CHECK(tiles.GetStats().retiringTiles == 2);
+
+    // Once frame 11 is done the tiles are unmapped and b gets its last tile
+    tiles.Request(b, 0, 12);
+    tiles.Update(12, 11, 16, plan);
+    CHECK(plan.unmap.size() == 2);
+    CHECK(TilesOfLevel(plan, b, 0).size() == 1);
+}
+
+TEST(TileManager_FailedTilesAreUnmappedAndRetried)
+{
+    TileManager tiles(8);
+    const uint32_t tex = tiles.AddTexture(ThreeLevels());
+
+    TileManager::Plan plan;
+    tiles.Update(1, 0, 16, plan);
+    CHECK(plan.map.size() == 1);
+    const TileManager::Tile packed = plan.map[0];
+
+    tiles.OnTilesFailed(plan.map);
+    CHECK(tiles.GetStats().loadingTiles == 0);
+    CHECK(tiles.GetStats().retiringTiles == 1);
+    CHECK(tiles.GetStats().tilesFailed == 1);
+    CHECK(tiles.ResidentMip(tex) == TileManager::kInvalid);
+
+    // Nothing sampled it: unmapped right away, and mapped again since it is still wanted
+    tiles.Update(2, 0, 16, plan);
+    CHECK(plan.unmap.size() == 1);
+    CHECK(plan.unmap[0].physical == packed.physical);
+    CHECK(plan.map.size() == 1);
+
+    std::vector<uint32_t> changed;
+    tiles.OnTilesLoaded(plan.map, changed);
+    CHECK(tiles.ResidentMip(tex) == 2);
+}
+
+TEST(TileManager_RemovedTextureReturnsTilesAfterFence)
+{
+    TileManager tiles(4);
+    const uint32_t tex = tiles.AddTexture(ThreeLevels());
+
+    TileManager::Plan plan;
+    std::vector<uint32_t> changed;
+    tiles.Update(1, 0, 16, plan);
+    tiles.OnTilesLoaded(plan.map, changed);
+
+    tiles.RemoveTexture(tex, 3);
+    CHECK(tiles.GetStats().residentTiles == 0);
+    CHECK(tiles.GetStats().retiringTiles == 1);
+
+    tiles.Update(3, 2, 16, plan);
+    CHECK(tiles.GetStats().freeTiles == 3);
+
+    // The resource is gone with the texture: no unmap is reported
+    tiles.Update(4, 3, 16, plan);
+    CHECK(plan.unmap.empty());
+    CHECK(tiles.GetStats().freeTiles == 4);
+}
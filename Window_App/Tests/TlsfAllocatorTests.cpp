@@ -0,0 +1,209 @@
+#include "TestFramework.h"
+#include "TlsfAllocator.h"
+
+#include <algorithm>
+#include <random>
+
+namespace
+{
+    struct Live
+    {
+        uint64_t offset;
+        uint64_t size;
+        uint32_t block;
+    };
+
+    bool Overlaps(const std::vector<Live>& live)
+    {
+        std::vector<Live> sorted = live;
+        std::sort(sorted.begin(), sorted.end(), [](const Live& a, const Live& b) { return a.offset < b.offset; });
+        for (size_t i = 1; i < sorted.size(); ++i)
+            if (sorted[i - 1].offset + sorted[i - 1].size > sorted[i].offset)
+                return true;
+        return false;
+    }
+}
+
+TEST(Tlsf_AllocateAndFree)
+{
+    TlsfAllocator tlsf(64 * 1024, 256);
+
+    TlsfAllocator::Allocation a = tlsf.Allocate(1000);
+    CHECK(a);
+    CHECK(a.size >= 1000);
+    CHECK(a.size % 256 == 0);
+    CHECK(a.offset + a.size <= tlsf.Capacity());
+    CHECK(!tlsf.Empty());
+    CHECK(tlsf.GetStats().usedBytes == a.size);
+
+    tlsf.Free(a.block);
+    CHECK(tlsf.Empty());
+    CHECK(tlsf.GetStats().usedBytes == 0);
+
+    // Zero bytes and more than the capacity both fail
+    CHECK(!tlsf.Allocate(0));
+    CHECK(!tlsf.Allocate(128 * 1024));
+}
+
+TEST(Tlsf_Alignment)
+{
+    TlsfAllocator tlsf(1 << 20, 256);
+
+    // Knock the free block off any large alignment first
+    CHECK(tlsf.Allocate(256));
+    for (uint64_t alignment = 256; alignment <= 64 * 1024; alignment <<= 1)
+    {
+        TlsfAllocator::Allocation a = tlsf.Allocate(300, alignment);
+        CHECK(a);
+        CHECK(a.offset % alignment == 0);
+    }
+
+    // Alignment below the granularity still yields granular offsets
+    TlsfAllocator::Allocation b = tlsf.Allocate(10, 16);
+    CHECK(b);
+    CHECK(b.offset % 256 == 0);
+}
+
+TEST(Tlsf_FreeBlocksCoalesce)
+{
+    TlsfAllocator tlsf(16 * 1024, 256);
+
+    TlsfAllocator::Allocation a = tlsf.Allocate(4096);
+    TlsfAllocator::Allocation b = tlsf.Allocate(4096);
+    TlsfAllocator::Allocation c = tlsf.Allocate(4096);
+    CHECK(a && b && c);
+
+    // Freeing out of order must still merge back into one block
+    tlsf.Free(a.block);
+    tlsf.Free(c.block);
+    CHECK(tlsf.GetStats().freeBlockCount >= 2);
+    tlsf.Free(b.block);
+
+    const TlsfAllocator::Stats s = tlsf.GetStats();
+    CHECK(s.freeBlockCount == 1);
+    CHECK(s.largestFreeBlock == tlsf.Capacity());
+    CHECK(s.Fragmentation() == 0.0);
+
+    // ...and hold the whole range again
+    TlsfAllocator::Allocation all = tlsf.Allocate(8 * 1024);
+    CHECK(all);
+}
+
+TEST(Tlsf_DoubleFreeIsIgnored)
+{
+    TlsfAllocator tlsf(16 * 1024, 256);
+    TlsfAllocator::Allocation a = tlsf.Allocate(1024);
+    TlsfAllocator::Allocation b = tlsf.Allocate(1024);
+    tlsf.Free(a.block);
+    tlsf.Free(a.block);
+    CHECK(tlsf.GetStats().allocationCount == 1);
+    CHECK(tlsf.GetStats().usedBytes == b.size);
+}
+
+TEST(Tlsf_StaleHandleIsIgnored)
+{
+    TlsfAllocator tlsf(16 * 1024, 256);
+
+    // a's block is handed out again as b (same offset, same slot)
+    TlsfAllocator::Allocation a = tlsf.Allocate(1024);
+    tlsf.Free(a.block);
+    TlsfAllocator::Allocation b = tlsf.Allocate(1024);
+    CHECK(b.offset == a.offset);
+    CHECK(b.block != a.block);
+
+    tlsf.Free(a.block);
+    CHECK(tlsf.GetStats().allocationCount == 1);
+    CHECK(tlsf.GetStats().usedBytes == b.size);
+
+    // c's slot is merged away on free, then reused by a split
+    TlsfAllocator::Allocation c = tlsf.Allocate(2048);
+    TlsfAllocator::Allocation d = tlsf.Allocate(2048);
+    tlsf.Free(c.block);
+    tlsf.Free(b.block);
+    TlsfAllocator::Allocation e = tlsf.Allocate(512);
+    TlsfAllocator::Allocation f = tlsf.Allocate(512);
+    CHECK(e && f);
+
+    tlsf.Free(c.block);
+    tlsf.Free(b.block);
+    CHECK(tlsf.GetStats().allocationCount == 3);
+    CHECK(tlsf.GetStats().usedBytes == d.size + e.size + f.size);
+
+    // The free lists are intact: everything merges back into one block
+    tlsf.Free(d.block);
+    tlsf.Free(e.block);
+    tlsf.Free(f.block);
+    CHECK(tlsf.Empty());
+    CHECK(tlsf.GetStats().freeBlockCount == 1);
+    CHECK(tlsf.GetStats().largestFreeBlock == tlsf.Capacity());
+    CHECK(tlsf.Allocate(tlsf.Capacity()));
+}
+
+TEST(Tlsf_RequiredCapacityFits)
+{
+    const uint64_t kMB = 1ull << 20;
+    const uint64_t sizes[] = { 4096, 12 * 1024, 5 * kMB + 4096, 68 * kMB, 100 * kMB, 130 * kMB, 200 * kMB, 256 * kMB };
+    const uint64_t alignments[] = { 4096, 64 * 1024, 4 * kMB };
+    for (uint64_t size : sizes)
+    {
+        for (uint64_t alignment : alignments)
+        {
+            const uint64_t capacity = TlsfAllocator::RequiredCapacity(size, alignment, 4096);
+            TlsfAllocator exact(capacity, 4096);
+            CHECK(exact.Allocate(size, alignment));
+
+            // It is also the smallest capacity that works
+            TlsfAllocator smaller(capacity - 4096, 4096);
+            CHECK(!smaller.Allocate(size, alignment));
+        }
+    }
+}
+
+TEST(Tlsf_RandomizedNoOverlap)
+{
+    const uint64_t kCapacity = 4 << 20;
+    TlsfAllocator tlsf(kCapacity, 256);
+    std::mt19937 rng(1234);
+    std::vector<Live> live;
+
+    for (int step = 0; step < 20000; ++step)
+    {
+        if (live.empty() || rng() % 3 != 0)
+        {
+            const uint64_t size = 1 + rng() % (64 * 1024);
+            const uint64_t alignment = 1ull << (rng() % 17);
+            TlsfAllocator::Allocation a = tlsf.Allocate(size, alignment);
+            if (!a) continue;
+            CHECK(a.size >= size);
+            CHECK(a.offset % alignment == 0);
+            CHECK(a.offset + a.size <= kCapacity);
+            live.push_back({ a.offset, a.size, a.block });
+        }
+        else
+        {
+            const size_t index = rng() % live.size();
+            tlsf.Free(live[index].block);
+            live[index] = live.back();
+            live.pop_back();
+        }
+
+        if (step % 500 == 0)
+        {
+            CHECK(!Overlaps(live));
+
+            uint64_t used = 0;
+            for (const Live& l : live) used += l.size;
+            const TlsfAllocator::Stats s = tlsf.GetStats();
+            CHECK(s.usedBytes == used);
+            CHECK(s.allocationCount == live.size());
+        }
+    }
+    CHECK(!Overlaps(live));
+
+    // Everything back: one free block spanning the capacity
+    for (const Live& l : live)
+        tlsf.Free(l.block);
+    CHECK(tlsf.Empty());
+    CHECK(tlsf.GetStats().freeBlockCount == 1);
+    CHECK(tlsf.GetStats().largestFreeBlock == kCapacity);
+}
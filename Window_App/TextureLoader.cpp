@@ -0,0 +1,494 @@
+#include "TextureLoader.h"
+#include <algorithm>
+#include "d3dx12.h"
+
+namespace
+{
+    UINT64 Now()
+    {
+        LARGE_INTEGER t;
+        QueryPerformanceCounter(&t);
+        return static_cast<UINT64>(t.QuadPart);
+    }
+
+    UINT64 AlignPlacement(UINT64 size)
+    {
+        const UINT64 a = D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT;
+        return (size + a - 1) & ~(a - 1);
+    }
+
+    D3D12_SHADER_RESOURCE_VIEW_DESC ViewDesc(const DdsImage& image)
+    {
+        D3D12_SHADER_RESOURCE_VIEW_DESC desc{};
+        desc.Format = image.format;
+        desc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+
+        const UINT arraySize = image.depthOrArraySize;
+        switch (image.dimension)
+        {
+        case D3D12_RESOURCE_DIMENSION_TEXTURE1D:
+            if (arraySize > 1)
+            {
+                desc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE1DARRAY;
+                desc.Texture1DArray.MipLevels = image.mipLevels;
+                desc.Texture1DArray.ArraySize = arraySize;
+            }
+            else
+            {
+                desc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE1D;
+                desc.Texture1D.MipLevels = image.mipLevels;
+            }
+            break;
+        case D3D12_RESOURCE_DIMENSION_TEXTURE3D:
+            desc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE3D;
+            desc.Texture3D.MipLevels = image.mipLevels;
+            break;
+        default:
+            if (image.cubemap && arraySize > 6)
+            {
+                desc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURECUBEARRAY;
+                desc.TextureCubeArray.MipLevels = image.mipLevels;
+                desc.TextureCubeArray.NumCubes = arraySize / 6;
+            }
+            else if (image.cubemap)
+            {
+                desc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURECUBE;
+                desc.TextureCube.MipLevels = image.mipLevels;
+            }
+            else if (arraySize > 1)
+            {
+                desc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2DARRAY;
+                desc.Texture2DArray.MipLevels = image.mipLevels;
+                desc.Texture2DArray.ArraySize = arraySize;
+            }
+            else
+            {
+                desc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
+                desc.Texture2D.MipLevels = image.mipLevels;
+            }
+            break;
+        }
+        return desc;
+    }
+}
+
+TextureLoader::MappedFile::~MappedFile()
+{
+    if (view) UnmapViewOfFile(view);
+    if (mapping) CloseHandle(mapping);
+    if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+}
+
+// -----------------------------------------------------------
+// Setup / teardown
+// -----------------------------------------------------------
+TextureLoader::~TextureLoader()
+{
+    Shutdown();
+}
+
+bool TextureLoader::Initialize(ID3D12Device* device, QueueScheduler* queues, CopyUploader* uploader,
+    GpuAllocator* allocator, DescriptorPool* viewPool, DescriptorRing* descriptors,
+    DeferredReleaseQueue* releases, UINT64 bytesPerFrame)
+{
+    m_device = device;
+    m_queues = queues;
+    m_uploader = uploader;
+    m_allocator = allocator;
+    m_viewPool = viewPool;
+    m_descriptors = descriptors;
+    m_releases = releases;
+    m_bytesPerFrame = bytesPerFrame;
+
+    LARGE_INTEGER freq;
+    QueryPerformanceFrequency(&freq);
+    m_qpcFrequency = static_cast<UINT64>(freq.QuadPart);
+
+    m_stop = false;
+    m_worker = std::thread(&TextureLoader::WorkerMain, this);
+    return true;
+}
+
+void TextureLoader::Shutdown()
+{
+    if (m_worker.joinable())
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_cv.notify_all();
+        m_worker.join();
+    }
+    m_requests.clear();
+    m_results.clear();
+
+    // Called after the GPU is idle: views and resources go right away
+    for (Texture& t : m_textures)
+    {
+        if (t.srv) m_viewPool->Free(t.srv);
+        if (t.handle != kInvalid) m_descriptors->RemovePersistent(t.handle);
+        if (t.allocation) m_allocator->Free(t.allocation);
+    }
+    m_textures.clear();
+    m_freeSlots.clear();
+    m_queued.clear();
+    m_batches.clear();
+}
+
+// -----------------------------------------------------------
+// Textures
+// -----------------------------------------------------------
+UINT32 TextureLoader::Load(const wchar_t* path)
+{
+    UINT32 id;
+    if (!m_freeSlots.empty())
+    {
+        id = m_freeSlots.back();
+        m_freeSlots.pop_back();
+    }
+    else
+    {
+        id = static_cast<UINT32>(m_textures.size());
+        m_textures.emplace_back();
+    }
+
+    Texture& t = m_textures[id];
+    t.state = State::Reading;
+    BeginPending();
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_requests.push_back({ { id, t.generation }, path });
+    }
+    m_cv.notify_one();
+    return id;
+}
+
+void TextureLoader::Release(UINT32 texture)
+{
+    Texture& t = m_textures[texture];
+    if (t.state == State::Free) return;
+    if (t.state != State::Ready && t.state != State::Failed)
+        EndPending();
+
+    // A read still on the worker is dropped by the generation check
+    ReleaseResources(t, texture);
+    const UINT32 generation = t.generation;
+    t = Texture{};
+    t.generation = generation + 1;
+    m_freeSlots.push_back(texture);
+}
+
+void TextureLoader::Fail(UINT32 texture)
+{
+    Texture& t = m_textures[texture];
+    ReleaseResources(t, texture);
+    t.file.reset();
+    t.image.subresources.clear();
+    t.state = State::Failed;
+    ++m_failed;
+    EndPending();
+}
+
+void TextureLoader::ReleaseResources(Texture& t, UINT32 texture)
+{
+    if (t.state == State::Queued)
+    {
+        m_queued.erase(std::remove_if(m_queued.begin(), m_queued.end(),
+            [texture](const Ticket& q) { return q.texture == texture; }), m_queued.end());
+    }
+
+    // Ready textures may be sampled by frames in flight; anything else
+    // was only touched by copies already submitted
+    const TimelinePoint lastUse = t.state == State::Ready
+        ? TimelinePoint{ QueueType::Direct, m_queues->NextValue(QueueType::Direct) }
+        : m_uploader->LastSubmitted();
+
+    if (t.srv || t.handle != kInvalid)
+    {
+        Descriptor srv = t.srv;
+        const UINT32 handle = t.handle;
+        DescriptorPool* pool = m_viewPool;
+        DescriptorRing* ring = m_descriptors;
+        m_releases->Release([pool, ring, srv, handle]() mutable
+        {
+            if (srv) pool->Free(srv);
+            if (handle != kInvalid) ring->RemovePersistent(handle);
+        }, lastUse);
+        t.srv = Descriptor{};
+        t.handle = kInvalid;
+    }
+
+    if (t.allocation)
+    {
+        GpuAllocation allocation = t.allocation;
+        GpuAllocator* allocator = m_allocator;
+        m_releases->Release([allocator, allocation]() mutable { allocator->Free(allocation); }, lastUse);
+        t.allocation = GpuAllocation{};
+    }
+}
+
+bool TextureLoader::IsCurrent(const Ticket& ticket) const
+{
+    const Texture& t = m_textures[ticket.texture];
+    return t.state != State::Free && t.generation == ticket.generation;
+}
+
+// -----------------------------------------------------------
+// Worker thread
+// -----------------------------------------------------------
+void TextureLoader::WorkerMain()
+{
+    for (;;)
+    {
+        Request request;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_cv.wait(lock, [this] { return m_stop || !m_requests.empty(); });
+            if (m_stop) return;
+            request = std::move(m_requests.front());
+            m_requests.pop_front();
+        }
+
+        Result result;
+        result.ticket = request.ticket;
+        result.ok = Map(request.path.c_str(), result);
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_results.push_back(std::move(result));
+    }
+}
+
+bool TextureLoader::Map(const wchar_t* path, Result& result)
+{
+    std::unique_ptr<MappedFile> file(new MappedFile);
+    file->file = CreateFileW(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+        FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file->file == INVALID_HANDLE_VALUE) return false;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file->file, &size) || size.QuadPart == 0) return false;
+    file->size = static_cast<UINT64>(size.QuadPart);
+
+    file->mapping = CreateFileMappingW(file->file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!file->mapping) return false;
+    file->view = MapViewOfFile(file->mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!file->view) return false;
+
+    if (!ParseDds(file->view, static_cast<size_t>(file->size), result.image)) return false;
+
+    // Fault the pages in here, not in the staging copy on the render thread
+    const volatile UINT8* bytes = static_cast<const volatile UINT8*>(file->view);
+    UINT8 sink = 0;
+    for (UINT64 i = 0; i < file->size; i += 4096)
+        sink ^= bytes[i];
+    (void)sink;
+
+    result.file = std::move(file);
+    return true;
+}
+
+// -----------------------------------------------------------
+// Per frame
+// -----------------------------------------------------------
+void TextureLoader::Update()
+{
+    CompleteBatches();
+    PlaceResults();
+    SubmitUploads();
+}
+
+void TextureLoader::CompleteBatches()
+{
+    while (!m_batches.empty() && m_queues->IsComplete(m_batches.front().done))
+    {
+        for (const Ticket& ticket : m_batches.front().completed)
+        {
+            if (IsCurrent(ticket))
+                PublishView(ticket.texture);
+        }
+        m_batches.pop_front();
+    }
+}
+
+void TextureLoader::PlaceResults()
+{
+    std::vector<Result> results;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        results.swap(m_results);
+    }
+
+    for (Result& result : results)
+    {
+        // Released while reading: the mapping closes with the result
+        if (!IsCurrent(result.ticket)) continue;
+
+        const UINT32 id = result.ticket.texture;
+        if (!result.ok)
+        {
+            Fail(id);
+            continue;
+        }
+
+        Texture& t = m_textures[id];
+        if (!m_allocator->CreateResource(D3D12_HEAP_TYPE_DEFAULT, result.image.ResourceDesc(),
+                D3D12_RESOURCE_STATE_COMMON, nullptr, t.allocation))
+        {
+            Fail(id);
+            continue;
+        }
+
+        t.file = std::move(result.file);
+        t.image = std::move(result.image);
+        t.dataBytes = t.image.DataBytes();
+        t.nextSubresource = 0;
+        t.state = State::Queued;
+        m_queued.push_back(result.ticket);
+    }
+}
+
+void TextureLoader::SubmitUploads()
+{
+    if (m_queued.empty()) return;
+
+    // One staging allocation per frame: never more than the ring hands out at once
+    const UINT64 maxBatch = m_uploader->MaxBatchBytes();
+    const UINT64 budget = m_bytesPerFrame < maxBatch ? m_bytesPerFrame : maxBatch;
+
+    m_uploads.clear();
+    std::vector<Ticket> staged;
+    CopyBatch batch;
+    UINT64 total = 0;
+
+    while (!m_queued.empty())
+    {
+        const Ticket ticket = m_queued.front();
+        Texture& t = m_textures[ticket.texture];
+        ID3D12Resource* resource = t.allocation.resource.Get();
+        const UINT count = static_cast<UINT>(t.image.subresources.size());
+
+        // As many subresources as fit; the first of a batch always goes
+        UINT end = t.nextSubresource;
+        while (end < count)
+        {
+            const UINT64 size = AlignPlacement(GetRequiredIntermediateSize(resource, end, 1));
+            const bool first = m_uploads.empty() && end == t.nextSubresource;
+            if (total + size > budget && !first) break;
+            total += size;
+            ++end;
+        }
+        if (end == t.nextSubresource) break;
+
+        // The page may have been evicted while the texture waited for budget
+        m_allocator->MarkUsed(t.allocation, TimelinePoint{});
+
+        TextureUpload upload;
+        upload.dst = resource;
+        upload.firstSubresource = t.nextSubresource;
+        upload.count = end - t.nextSubresource;
+        upload.data = t.image.subresources.data() + t.nextSubresource;
+        m_uploads.push_back(upload);
+        staged.push_back(ticket);
+        t.nextSubresource = end;
+
+        // The rest of a large texture goes next frame
+        if (end < count) break;
+
+        t.state = State::Uploading;
+        batch.completed.push_back(ticket);
+        m_queued.pop_front();
+    }
+    if (m_uploads.empty()) return;
+
+    // Nothing was queued if this fails, so there is nothing to submit
+    if (!m_uploader->UploadTextures(m_uploads.data(), static_cast<UINT>(m_uploads.size())))
+    {
+        for (const Ticket& ticket : staged)
+            Fail(ticket.texture);
+        return;
+    }
+    batch.done = m_uploader->Flush();
+    ++m_batchCount;
+
+    // The copy queue writes the pages until the batch completes
+    for (const Ticket& ticket : staged)
+        m_allocator->MarkUsed(m_textures[ticket.texture].allocation, batch.done);
+
+    // Texels are in staging now; the files are no longer needed
+    for (const Ticket& ticket : batch.completed)
+    {
+        Texture& t = m_textures[ticket.texture];
+        t.file.reset();
+        t.image.subresources.clear();
+    }
+    m_batches.push_back(std::move(batch));
+}
+
+// -----------------------------------------------------------
+// Views
+// -----------------------------------------------------------
+void TextureLoader::PublishView(UINT32 texture)
+{
+    Texture& t = m_textures[texture];
+
+    t.srv = m_viewPool->Allocate();
+    if (!t.srv)
+    {
+        Fail(texture);
+        return;
+    }
+
+    const D3D12_SHADER_RESOURCE_VIEW_DESC desc = ViewDesc(t.image);
+    m_device->CreateShaderResourceView(t.allocation.resource.Get(), &desc, t.srv.cpu);
+
+    // kInvalid without bindless: the SRV is still usable through Resource()
+    t.handle = m_descriptors->AddPersistent(t.srv.cpu);
+
+    t.state = State::Ready;
+    ++m_loaded;
+    m_bytesLoaded += t.dataBytes;
+    EndPending();
+}
+
+void TextureLoader::MarkUsed(UINT32 texture, const TimelinePoint& point)
+{
+    const Texture& t = m_textures[texture];
+    if (t.allocation)
+        m_allocator->MarkUsed(t.allocation, point);
+}
+
+// -----------------------------------------------------------
+// Stats
+// -----------------------------------------------------------
+void TextureLoader::BeginPending()
+{
+    if (m_pending++ == 0)
+        m_activeSince = Now();
+}
+
+void TextureLoader::EndPending()
+{
+    if (--m_pending == 0)
+        m_activeTicks += Now() - m_activeSince;
+}
+
+TextureLoader::Stats TextureLoader::GetStats() const
+{
+    Stats s;
+    s.pending = m_pending;
+    s.loaded = m_loaded;
+    s.failed = m_failed;
+    s.batches = m_batchCount;
+    s.bytesLoaded = m_bytesLoaded;
+
+    UINT64 ticks = m_activeTicks;
+    if (m_pending > 0) ticks += Now() - m_activeSince;
+    if (ticks > 0)
+    {
+        const double seconds = static_cast<double>(ticks) / static_cast<double>(m_qpcFrequency);
+        s.throughputMBps = static_cast<double>(m_bytesLoaded) / (1024.0 * 1024.0) / seconds;
+    }
+    return s;
+}
@@ -0,0 +1,197 @@
+#pragma once
+
+#include <windows.h>
+#include <wrl.h>
+#include <d3d12.h>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "CopyUploader.h"
+#include "DdsFile.h"
+#include "DeferredReleaseQueue.h"
+#include "DescriptorAllocator.h"
+#include "GpuAllocator.h"
+#include "QueueScheduler.h"
+
+using Microsoft::WRL::ComPtr;
+
+// -----------------------------------------------------------
+// TextureLoader
+//   Loads DDS textures without stalling the render thread:
+//     - a worker thread memory-maps the file, parses the header
+//       (ParseDds) and touches every page so the copy does not
+//       fault on disk later,
+//     - Update() places the texture with GpuAllocator and gathers
+//       the subresources of every waiting texture, up to a per-frame
+//       byte budget, into ONE CopyUploader::UploadTextures call
+//       (one staging allocation) and one copy-queue submit,
+//     - the file is unmapped as soon as its last subresource is
+//       staged; once the submit completes, the SRV is published as
+//       a bindless handle.
+//   Textures larger than the budget are split by subresource over
+//   several frames; a subresource larger than the staging ring goes
+//   alone and CopyUploader splits it into rows. Render thread only
+//   (apart from the worker).
+// -----------------------------------------------------------
+class TextureLoader
+{
+public:
+    static constexpr UINT32 kInvalid = 0xFFFFFFFFu;
+
+    struct Stats
+    {
+        UINT32 pending = 0;         ///< reading, queued or uploading
+        UINT32 loaded = 0;
+        UINT32 failed = 0;
+        UINT32 batches = 0;         ///< copy-queue submits
+        UINT64 bytesLoaded = 0;     ///< texel data of loaded textures
+        double throughputMBps = 0.0;    ///< bytesLoaded over the time anything was pending
+    };
+
+    TextureLoader() = default;
+    ~TextureLoader();
+
+    TextureLoader(const TextureLoader&) = delete;
+    TextureLoader& operator=(const TextureLoader&) = delete;
+
+    bool Initialize(ID3D12Device* device, QueueScheduler* queues, CopyUploader* uploader,
+        GpuAllocator* allocator, DescriptorPool* viewPool, DescriptorRing* descriptors,
+        DeferredReleaseQueue* releases, UINT64 bytesPerFrame);
+
+    /// Called after the GPU is idle.
+    void Shutdown();
+
+    /// Returns a texture id right away; the file is read in the background.
+    UINT32 Load(const wchar_t* path);
+    void Release(UINT32 texture);
+
+    void Update();
+
+    /// Something is still reading or uploading (keeps idle mode rendering).
+    bool IsBusy() const { return m_pending > 0; }
+
+    /// Stamps the texture's heap with the frame that samples it (residency mode).
+    void MarkUsed(UINT32 texture, const TimelinePoint& point);
+
+    bool IsReady(UINT32 texture) const { return m_textures[texture].state == State::Ready; }
+    bool IsFailed(UINT32 texture) const { return m_textures[texture].state == State::Failed; }
+
+    /// Bindless handle (kInvalid until ready).
+    UINT32 Handle(UINT32 texture) const { return m_textures[texture].handle; }
+    ID3D12Resource* Resource(UINT32 texture) const { return m_textures[texture].allocation.resource.Get(); }
+
+    Stats GetStats() const;
+
+private:
+    // Read-only view of a whole file
+    struct MappedFile
+    {
+        HANDLE file = INVALID_HANDLE_VALUE;
+        HANDLE mapping = nullptr;
+        const void* view = nullptr;
+        UINT64 size = 0;
+
+        ~MappedFile();
+    };
+
+    enum class State : UINT8
+    {
+        Free,
+        Reading,    ///< worker thread
+        Queued,     ///< placed, subresources waiting for the copy budget
+        Uploading,  ///< every subresource submitted
+        Ready,
+        Failed,
+    };
+
+    struct Texture
+    {
+        State state = State::Free;
+        UINT32 generation = 0;
+        std::unique_ptr<MappedFile> file;
+        DdsImage image;             ///< subresources point into file
+        UINT64 dataBytes = 0;
+        GpuAllocation allocation;
+        UINT nextSubresource = 0;   ///< first subresource not yet staged
+        Descriptor srv;
+        UINT32 handle = kInvalid;
+    };
+
+    struct Ticket
+    {
+        UINT32 texture;
+        UINT32 generation;
+    };
+
+    struct Request
+    {
+        Ticket ticket;
+        std::wstring path;
+    };
+
+    struct Result
+    {
+        Ticket ticket;
+        std::unique_ptr<MappedFile> file;
+        DdsImage image;
+        bool ok = false;
+    };
+
+    struct CopyBatch
+    {
+        TimelinePoint done;
+        std::vector<Ticket> completed;  ///< textures whose last subresource is in this batch
+    };
+
+    void WorkerMain();
+    static bool Map(const wchar_t* path, Result& result);
+
+    bool IsCurrent(const Ticket& ticket) const;
+    void CompleteBatches();
+    void PlaceResults();
+    void SubmitUploads();
+    void PublishView(UINT32 texture);
+    void Fail(UINT32 texture);
+    void ReleaseResources(Texture& t, UINT32 texture);
+    void BeginPending();
+    void EndPending();
+
+private:
+    ID3D12Device* m_device = nullptr;
+    QueueScheduler* m_queues = nullptr;
+    CopyUploader* m_uploader = nullptr;
+    GpuAllocator* m_allocator = nullptr;
+    DescriptorPool* m_viewPool = nullptr;
+    DescriptorRing* m_descriptors = nullptr;
+    DeferredReleaseQueue* m_releases = nullptr;
+    UINT64 m_bytesPerFrame = 0;
+
+    std::vector<Texture> m_textures;    ///< by id
+    std::vector<UINT32> m_freeSlots;
+    std::deque<Ticket> m_queued;        ///< placed, in upload order
+    std::deque<CopyBatch> m_batches;
+    std::vector<TextureUpload> m_uploads;   ///< scratch for SubmitUploads
+
+    // Worker thread
+    std::thread m_worker;
+    mutable std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::deque<Request> m_requests;
+    std::vector<Result> m_results;
+    bool m_stop = false;
+
+    // Stats
+    UINT32 m_pending = 0;
+    UINT32 m_loaded = 0;
+    UINT32 m_failed = 0;
+    UINT32 m_batchCount = 0;
+    UINT64 m_bytesLoaded = 0;
+    UINT64 m_activeSince = 0;           ///< QPC when m_pending left 0
+    UINT64 m_activeTicks = 0;           ///< closed busy intervals
+    UINT64 m_qpcFrequency = 1;
+};
@@ -0,0 +1,474 @@
+#include "TextureStreamer.h"
+#include <algorithm>
+#include "d3dx12.h"
+
+namespace
+{
+    bool ReadAt(HANDLE file, UINT64 offset, void* dst, UINT32 size)
+    {
+        OVERLAPPED ov{};
+        ov.Offset = static_cast<DWORD>(offset);
+        ov.OffsetHigh = static_cast<DWORD>(offset >> 32);
+        DWORD read = 0;
+        return ReadFile(file, dst, size, &read, &ov) && read == size;
+    }
+}
+
+// -----------------------------------------------------------
+// Setup / teardown
+// -----------------------------------------------------------
+TextureStreamer::~TextureStreamer()
+{
+    Shutdown();
+}
+
+bool TextureStreamer::Initialize(ID3D12Device* device, QueueScheduler* queues, CopyUploader* uploader,
+    DescriptorPool* viewPool, DescriptorRing* descriptors, DeferredReleaseQueue* releases,
+    UINT64 poolBytes, UINT64 bytesPerFrame)
+{
+    m_device = device;
+    m_queues = queues;
+    m_uploader = uploader;
+    m_viewPool = viewPool;
+    m_descriptors = descriptors;
+    m_releases = releases;
+
+    D3D12_FEATURE_DATA_D3D12_OPTIONS options{};
+    if (FAILED(device->CheckFeatureSupport(D3D12_FEATURE_D3D12_OPTIONS, &options, sizeof(options))))
+        return false;
+    if (options.TiledResourcesTier == D3D12_TILED_RESOURCES_TIER_NOT_SUPPORTED || poolBytes == 0)
+        return true;
+
+    const UINT32 poolTiles = static_cast<UINT32>(poolBytes / D3D12_TILED_RESOURCE_TILE_SIZE_IN_BYTES);
+    CD3DX12_HEAP_DESC desc(static_cast<UINT64>(poolTiles) * D3D12_TILED_RESOURCE_TILE_SIZE_IN_BYTES,
+        D3D12_HEAP_TYPE_DEFAULT, 0, D3D12_HEAP_FLAG_DENY_BUFFERS | D3D12_HEAP_FLAG_DENY_RT_DS_TEXTURES);
+    if (FAILED(device->CreateHeap(&desc, IID_PPV_ARGS(&m_heap))))
+        return false;
+    m_heap->SetName(L"Streaming Tile Pool");
+
+    m_tiles.Reset(poolTiles);
+    m_tileBudget = static_cast<UINT32>(bytesPerFrame / D3D12_TILED_RESOURCE_TILE_SIZE_IN_BYTES);
+    if (m_tileBudget == 0) m_tileBudget = 1;
+
+    m_stop = false;
+    m_reader = std::thread(&TextureStreamer::ReaderMain, this);
+    return true;
+}
+
+void TextureStreamer::Shutdown()
+{
+    if (m_reader.joinable())
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_readMutex);
+            m_stop = true;
+        }
+        m_readCv.notify_all();
+        m_reader.join();
+    }
+    m_reads.clear();
+    m_finished.clear();
+
+    // Called after the GPU is idle: views and resources go right away
+    for (Texture& t : m_textures)
+    {
+        if (t.srv) m_viewPool->Free(t.srv);
+        if (t.handle != TileManager::kInvalid) m_descriptors->RemovePersistent(t.handle);
+    }
+    m_textures.clear();
+    m_copies.clear();
+    m_heap.Reset();
+}
+
+// -----------------------------------------------------------
+// Textures
+// -----------------------------------------------------------
+UINT32 TextureStreamer::Open(const wchar_t* path)
+{
+    if (!IsSupported()) return TileManager::kInvalid;
+
+    HANDLE raw = CreateFileW(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+        FILE_FLAG_RANDOM_ACCESS, nullptr);
+    if (raw == INVALID_HANDLE_VALUE) return TileManager::kInvalid;
+    FileHandle file(raw, CloseHandle);
+
+    StreamFileHeader header;
+    if (!ReadAt(raw, 0, &header, sizeof(header)) ||
+        header.magic != StreamFileHeader::kMagic || header.version != StreamFileHeader::kVersion)
+        return TileManager::kInvalid;
+
+    std::vector<StreamPackedMip> packed(header.packedMips);
+    if (header.packedMips > 0 &&
+        !ReadAt(raw, sizeof(header), packed.data(), static_cast<UINT32>(packed.size() * sizeof(StreamPackedMip))))
+        return TileManager::kInvalid;
+
+    // Reserved resource: no memory until tiles are mapped
+    D3D12_RESOURCE_DESC desc = CD3DX12_RESOURCE_DESC::Tex2D(static_cast<DXGI_FORMAT>(header.format),
+        header.width, header.height, 1, static_cast<UINT16>(header.mipLevels));
+    desc.Layout = D3D12_TEXTURE_LAYOUT_64KB_UNDEFINED_SWIZZLE;
+
+    ComPtr<ID3D12Resource> resource;
+    if (FAILED(m_device->CreateReservedResource(&desc, D3D12_RESOURCE_STATE_COMMON, nullptr, IID_PPV_ARGS(&resource))))
+        return TileManager::kInvalid;
+
+    UINT numTiles = 0;
+    D3D12_PACKED_MIP_INFO packedInfo{};
+    D3D12_TILE_SHAPE shape{};
+    UINT subresourceCount = header.mipLevels;
+    std::vector<D3D12_SUBRESOURCE_TILING> tilings(subresourceCount);
+    m_device->GetResourceTiling(resource.Get(), &numTiles, &packedInfo, &shape, &subresourceCount, 0, tilings.data());
+
+    // The file was cooked for this tiling
+    if (packedInfo.NumStandardMips != header.standardMips || packedInfo.NumPackedMips != header.packedMips)
+        return TileManager::kInvalid;
+
+    Texture t;
+    t.live = true;
+    t.resource = resource;
+    t.file = file;
+    t.format = desc.Format;
+    t.mipLevels = header.mipLevels;
+    t.standardMips = header.standardMips;
+    t.packed = packed;
+    t.tileDataOffset = sizeof(header) + packed.size() * sizeof(StreamPackedMip);
+
+    TileManager::TextureLayout layout;
+    UINT32 fileTiles = 0;
+    for (UINT m = 0; m < t.standardMips; ++m)
+    {
+        layout.mips.push_back({ tilings[m].WidthInTiles, tilings[m].HeightInTiles });
+        t.levelFirstTile.push_back(fileTiles);
+        fileTiles += tilings[m].WidthInTiles * tilings[m].HeightInTiles;
+    }
+    layout.packedTiles = packedInfo.NumTilesForPackedMips;
+
+    t.packedDataOffset = t.tileDataOffset + static_cast<UINT64>(fileTiles) * D3D12_TILED_RESOURCE_TILE_SIZE_IN_BYTES;
+    for (const StreamPackedMip& p : packed)
+        t.packedDataSize += static_cast<UINT64>(p.rowPitch) * p.rowCount;
+
+    const UINT32 id = m_tiles.AddTexture(layout);
+    if (id >= m_textures.size()) m_textures.resize(id + 1);
+    t.generation = m_textures[id].generation + 1;
+    m_textures[id] = std::move(t);
+
+    // Coarsest mips are wanted from the start
+    RequestMip(id, m_textures[id].mipLevels - 1);
+    return id;
+}
+
+void TextureStreamer::Close(UINT32 texture)
+{
+    Texture& t = m_textures[texture];
+    if (!t.live) return;
+
+    // Copies into the resource run on the copy queue; let them land first
+    if (t.copiesInFlight > 0)
+        m_queues->WaitCpu(m_uploader->LastSubmitted());
+
+    const TimelinePoint lastUse{ QueueType::Direct, m_queues->NextValue(QueueType::Direct) };
+    m_tiles.RemoveTexture(texture, lastUse.value);
+    ReleaseView(t);
+    m_releases->Release(t.resource, lastUse);
+
+    // Reads still queued for it are dropped by the generation check
+    const UINT32 generation = t.generation;
+    t = Texture{};
+    t.generation = generation;
+}
+
+void TextureStreamer::RequestMip(UINT32 texture, UINT mip)
+{
+    if (m_textures[texture].live)
+        m_tiles.Request(texture, mip, m_queues->NextValue(QueueType::Direct));
+}
+
+// -----------------------------------------------------------
+// Per frame
+// -----------------------------------------------------------
+void TextureStreamer::Update(UINT64 frameFence, UINT64 completedFence)
+{
+    if (!IsSupported()) return;
+
+    m_changed.clear();
+
+    // Fills that have landed make their levels resident
+    while (!m_copies.empty() && m_queues->IsComplete(m_copies.front().done))
+    {
+        CopyBatch& batch = m_copies.front();
+        for (const TileManager::Tile& tile : batch.tiles)
+            --m_textures[tile.texture].copiesInFlight;
+        m_tiles.OnTilesLoaded(batch.tiles, m_changed);
+        m_copies.pop_front();
+    }
+
+    SubmitFinishedReads();
+
+    // New mappings go ahead of any copy that fills them on the same queue
+    m_tiles.Update(frameFence, completedFence, m_tileBudget, m_plan);
+    ApplyMappings(m_plan.unmap, false);
+    ApplyMappings(m_plan.map, true);
+    QueueReads(m_plan.map);
+
+    for (UINT32 id : m_plan.changed)
+        if (std::find(m_changed.begin(), m_changed.end(), id) == m_changed.end())
+            m_changed.push_back(id);
+    for (UINT32 id : m_changed)
+        PublishView(id);
+}
+
+void TextureStreamer::ApplyMappings(const std::vector<TileManager::Tile>& tiles, bool map)
+{
+    ID3D12CommandQueue* queue = m_queues->GetQueue(QueueType::Copy);
+
+    std::vector<D3D12_TILED_RESOURCE_COORDINATE> coords;
+    std::vector<D3D12_TILE_REGION_SIZE> sizes;
+    std::vector<D3D12_TILE_RANGE_FLAGS> flags;
+    std::vector<UINT> offsets;
+    std::vector<UINT> counts;
+
+    // One call per run of tiles of the same texture
+    for (size_t begin = 0; begin < tiles.size();)
+    {
+        const UINT32 id = tiles[begin].texture;
+        size_t end = begin;
+        while (end < tiles.size() && tiles[end].texture == id) ++end;
+
+        const Texture& t = m_textures[id];
+        coords.clear(); sizes.clear(); flags.clear(); offsets.clear(); counts.clear();
+        for (size_t i = begin; i < end; ++i)
+        {
+            const TileManager::Tile& tile = tiles[i];
+            const bool packed = m_tiles.IsPackedLevel(id, tile.level);
+
+            // Packed mips: X is the tile index inside the packed region
+            D3D12_TILED_RESOURCE_COORDINATE c{};
+            c.X = tile.x;
+            c.Y = packed ? 0 : tile.y;
+            c.Subresource = packed ? t.standardMips : tile.level;
+            coords.push_back(c);
+
+            D3D12_TILE_REGION_SIZE s{};
+            s.NumTiles = 1;
+            sizes.push_back(s);
+
+            if (map)
+            {
+                flags.push_back(D3D12_TILE_RANGE_FLAG_NONE);
+                offsets.push_back(tile.physical);
+                counts.push_back(1);
+            }
+        }
+
+        const UINT regionCount = static_cast<UINT>(coords.size());
+        if (map)
+        {
+            queue->UpdateTileMappings(t.resource.Get(), regionCount, coords.data(), sizes.data(),
+                m_heap.Get(), regionCount, flags.data(), offsets.data(), counts.data(), D3D12_TILE_MAPPING_FLAG_NONE);
+        }
+        else
+        {
+            const D3D12_TILE_RANGE_FLAGS nullFlag = D3D12_TILE_RANGE_FLAG_NULL;
+            queue->UpdateTileMappings(t.resource.Get(), regionCount, coords.data(), sizes.data(),
+                nullptr, 1, &nullFlag, nullptr, &regionCount, D3D12_TILE_MAPPING_FLAG_NONE);
+        }
+        begin = end;
+    }
+}
+
+void TextureStreamer::QueueReads(const std::vector<TileManager::Tile>& tiles)
+{
+    if (tiles.empty()) return;
+
+    {
+        std::lock_guard<std::mutex> lock(m_readMutex);
+        for (size_t i = 0; i < tiles.size(); ++i)
+        {
+            const TileManager::Tile& tile = tiles[i];
+            const Texture& t = m_textures[tile.texture];
+
+            Read read;
+            read.texture = tile.texture;
+            read.generation = t.generation;
+            read.file = t.file;
+
+            if (m_tiles.IsPackedLevel(tile.texture, tile.level))
+            {
+                // The whole packed level is mapped in one plan and read at once
+                while (i < tiles.size() && tiles[i].texture == tile.texture && tiles[i].level == tile.level)
+                    read.tiles.push_back(tiles[i++]);
+                --i;
+                read.offset = t.packedDataOffset;
+                read.size = static_cast<UINT32>(t.packedDataSize);
+            }
+            else
+            {
+                const UINT64 fileTile = t.levelFirstTile[tile.level] +
+                    tile.y * static_cast<UINT64>(m_tiles.LevelWidthInTiles(tile.texture, tile.level)) + tile.x;
+                read.tiles.push_back(tile);
+                read.offset = t.tileDataOffset + fileTile * D3D12_TILED_RESOURCE_TILE_SIZE_IN_BYTES;
+                read.size = D3D12_TILED_RESOURCE_TILE_SIZE_IN_BYTES;
+            }
+
+            m_reads.push_back(std::move(read));
+            ++m_readsInFlight;
+        }
+    }
+    m_readCv.notify_one();
+}
+
+void TextureStreamer::ReaderMain()
+{
+    for (;;)
+    {
+        Read read;
+        {
+            std::unique_lock<std::mutex> lock(m_readMutex);
+            m_readCv.wait(lock, [this] { return m_stop || !m_reads.empty(); });
+            if (m_stop) return;
+            read = std::move(m_reads.front());
+            m_reads.pop_front();
+        }
+
+        read.data.resize(read.size);
+        read.ok = ReadAt(read.file.get(), read.offset, read.data.data(), read.size);
+
+        std::lock_guard<std::mutex> lock(m_readMutex);
+        m_bytesRead += read.size;
+        m_finished.push_back(std::move(read));
+    }
+}
+
+void TextureStreamer::SubmitFinishedReads()
+{
+    std::vector<Read> finished;
+    {
+        std::lock_guard<std::mutex> lock(m_readMutex);
+        finished.swap(m_finished);
+        m_readsInFlight -= static_cast<UINT32>(finished.size());
+    }
+    if (finished.empty()) return;
+
+    CopyBatch batch;
+    std::vector<TileManager::Tile> failed;
+    for (Read& read : finished)
+    {
+        Texture& t = m_textures[read.texture];
+        if (!t.live || t.generation != read.generation) continue;
+        if (!read.ok)
+        {
+            failed.insert(failed.end(), read.tiles.begin(), read.tiles.end());
+            continue;
+        }
+
+        const TileManager::Tile& first = read.tiles.front();
+        bool queued;
+        if (m_tiles.IsPackedLevel(read.texture, first.level))
+        {
+            std::vector<D3D12_SUBRESOURCE_DATA> subresources;
+            const UINT8* src = read.data.data();
+            for (const StreamPackedMip& p : t.packed)
+            {
+                D3D12_SUBRESOURCE_DATA sub{};
+                sub.pData = src;
+                sub.RowPitch = p.rowPitch;
+                sub.SlicePitch = static_cast<LONG_PTR>(p.rowPitch) * p.rowCount;
+                subresources.push_back(sub);
+                src += sub.SlicePitch;
+            }
+            queued = m_uploader->UploadTexture(t.resource.Get(), t.standardMips,
+                static_cast<UINT>(subresources.size()), subresources.data());
+        }
+        else
+        {
+            D3D12_TILED_RESOURCE_COORDINATE c{};
+            c.X = first.x;
+            c.Y = first.y;
+            c.Subresource = first.level;
+            queued = m_uploader->UploadTiles(t.resource.Get(), c, 1, read.data.data());
+        }
+
+        if (!queued)
+        {
+            failed.insert(failed.end(), read.tiles.begin(), read.tiles.end());
+            continue;
+        }
+        t.copiesInFlight += static_cast<UINT32>(read.tiles.size());
+        batch.tiles.insert(batch.tiles.end(), read.tiles.begin(), read.tiles.end());
+    }
+
+    // Otherwise they would stay Loading (and hold pool tiles) forever
+    m_tiles.OnTilesFailed(failed);
+
+    if (batch.tiles.empty()) return;
+    batch.done = m_uploader->Flush();
+    m_copies.push_back(std::move(batch));
+}
+
+// -----------------------------------------------------------
+// Views
+// -----------------------------------------------------------
+void TextureStreamer::PublishView(UINT32 texture)
+{
+    Texture& t = m_textures[texture];
+    if (!t.live) return;
+
+    // Frames already recorded keep sampling through the old handle
+    ReleaseView(t);
+
+    const UINT mip = m_tiles.ResidentMip(texture);
+    if (mip == TileManager::kInvalid) return;
+
+    t.srv = m_viewPool->Allocate();
+    if (!t.srv) return;
+
+    D3D12_SHADER_RESOURCE_VIEW_DESC desc{};
+    desc.Format = t.format;
+    desc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
+    desc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+    desc.Texture2D.MostDetailedMip = 0;
+    desc.Texture2D.MipLevels = t.mipLevels;
+    desc.Texture2D.ResourceMinLODClamp = static_cast<float>(mip);
+    m_device->CreateShaderResourceView(t.resource.Get(), &desc, t.srv.cpu);
+
+    t.handle = m_descriptors->AddPersistent(t.srv.cpu);
+}
+
+void TextureStreamer::ReleaseView(Texture& t)
+{
+    if (!t.srv && t.handle == TileManager::kInvalid) return;
+
+    Descriptor srv = t.srv;
+    const UINT32 handle = t.handle;
+    DescriptorPool* pool = m_viewPool;
+    DescriptorRing* ring = m_descriptors;
+    m_releases->Release([pool, ring, srv, handle]() mutable
+    {
+        pool->Free(srv);
+        if (handle != TileManager::kInvalid) ring->RemovePersistent(handle);
+    }, { QueueType::Direct, m_queues->NextValue(QueueType::Direct) });
+
+    t.srv = Descriptor{};
+    t.handle = TileManager::kInvalid;
+}
+
+bool TextureStreamer::IsBusy() const
+{
+    if (!IsSupported()) return false;
+    if (!m_copies.empty() || !m_plan.map.empty() || !m_plan.unmap.empty()) return true;
+
+    std::lock_guard<std::mutex> lock(m_readMutex);
+    return m_readsInFlight > 0;
+}
+
+TextureStreamer::Stats TextureStreamer::GetStats() const
+{
+    Stats s;
+    s.tiles = m_tiles.GetStats();
+    for (const Texture& t : m_textures)
+        if (t.live) ++s.textureCount;
+
+    std::lock_guard<std::mutex> lock(m_readMutex);
+    s.pendingReads = m_readsInFlight;
+    s.bytesRead = m_bytesRead;
+    return s;
+}
@@ -0,0 +1,181 @@
+#pragma once
+
+#include <windows.h>
+#include <wrl.h>
+#include <d3d12.h>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "CopyUploader.h"
+#include "DeferredReleaseQueue.h"
+#include "DescriptorAllocator.h"
+#include "QueueScheduler.h"
+#include "TileManager.h"
+
+using Microsoft::WRL::ComPtr;
+
+// Streamed texture file (.tstream):
+//   StreamFileHeader
+//   StreamPackedMip[packedMips]
+//   standard mips, finest first: WidthInTiles x HeightInTiles tiles each,
+//     row-major, 64KB of linear texel data per tile (tile shape from
+//     GetResourceTiling for the format)
+//   packed mips, finest first: RowCount rows of RowPitch bytes each
+struct StreamFileHeader
+{
+    static constexpr UINT32 kMagic = 0x4D525453;    ///< 'STRM'
+    static constexpr UINT32 kVersion = 1;
+
+    UINT32 magic = kMagic;
+    UINT32 version = kVersion;
+    UINT32 width = 0;
+    UINT32 height = 0;
+    UINT32 mipLevels = 0;
+    UINT32 format = 0;          ///< DXGI_FORMAT
+    UINT32 standardMips = 0;    ///< must match GetResourceTiling
+    UINT32 packedMips = 0;
+};
+
+struct StreamPackedMip
+{
+    UINT32 rowPitch = 0;
+    UINT32 rowCount = 0;
+};
+
+// -----------------------------------------------------------
+// TextureStreamer
+//   Large textures as reserved (tiled) resources whose tiles are
+//   backed by one shared tile heap. TileManager decides from usage
+//   feedback (RequestMip) which tiles are mapped; Update() applies
+//   its plan once per frame:
+//     - UpdateTileMappings on the copy queue (maps, then NULL unmaps),
+//     - disk reads of the new tiles on a reader thread, limited to a
+//       per-frame byte budget,
+//     - finished reads copied in with CopyTiles (packed mips with
+//       CopyTextureRegion) through CopyUploader,
+//     - once the copy completes, the view is republished with the
+//       new ResourceMinLODClamp under a fresh bindless handle; the
+//       old handle is released after the frames using it finish.
+//   Render thread only (apart from the internal reader thread).
+// -----------------------------------------------------------
+class TextureStreamer
+{
+public:
+    struct Stats
+    {
+        TileManager::Stats tiles;
+        UINT32 textureCount = 0;
+        UINT32 pendingReads = 0;    ///< queued + in flight on the reader thread
+        UINT64 bytesRead = 0;
+    };
+
+    TextureStreamer() = default;
+    ~TextureStreamer();
+
+    TextureStreamer(const TextureStreamer&) = delete;
+    TextureStreamer& operator=(const TextureStreamer&) = delete;
+
+    /// Returns true without enabling streaming if tiled resources are unsupported.
+    bool Initialize(ID3D12Device* device, QueueScheduler* queues, CopyUploader* uploader,
+        DescriptorPool* viewPool, DescriptorRing* descriptors, DeferredReleaseQueue* releases,
+        UINT64 poolBytes, UINT64 bytesPerFrame);
+    void Shutdown();
+
+    bool IsSupported() const { return m_heap != nullptr; }
+
+    /// Returns a texture id, or TileManager::kInvalid.
+    UINT32 Open(const wchar_t* path);
+    void Close(UINT32 texture);
+
+    /// Usage feedback for the frame being recorded: mips >= mip are sampled.
+    void RequestMip(UINT32 texture, UINT mip);
+
+    void Update(UINT64 frameFence, UINT64 completedFence);
+
+    /// Reads or copies are in flight, or the last plan changed mappings
+    /// (keeps idle mode rendering so Update() runs).
+    bool IsBusy() const;
+
+    /// Bindless handle of the current view (kInvalid until the coarsest mips are in).
+    UINT32 Handle(UINT32 texture) const { return m_textures[texture].handle; }
+    UINT ResidentMip(UINT32 texture) const { return m_tiles.ResidentMip(texture); }
+
+    Stats GetStats() const;
+
+private:
+    using FileHandle = std::shared_ptr<void>;
+
+    struct Texture
+    {
+        bool live = false;
+        UINT32 generation = 0;
+        ComPtr<ID3D12Resource> resource;
+        FileHandle file;
+        DXGI_FORMAT format = DXGI_FORMAT_UNKNOWN;
+        UINT mipLevels = 0;
+        UINT standardMips = 0;
+        std::vector<StreamPackedMip> packed;
+        std::vector<UINT32> levelFirstTile;     ///< per standard mip, tile index in the file
+        UINT64 tileDataOffset = 0;
+        UINT64 packedDataOffset = 0;
+        UINT64 packedDataSize = 0;
+        UINT32 copiesInFlight = 0;
+        Descriptor srv;
+        UINT32 handle = TileManager::kInvalid;
+    };
+
+    struct Read
+    {
+        UINT32 texture;
+        UINT32 generation;
+        FileHandle file;
+        UINT64 offset;
+        UINT32 size;
+        std::vector<TileManager::Tile> tiles;   ///< one tile, or every tile of the packed level
+        std::vector<UINT8> data;
+        bool ok = false;
+    };
+
+    struct CopyBatch
+    {
+        TimelinePoint done;
+        std::vector<TileManager::Tile> tiles;
+    };
+
+    void ReaderMain();
+    void ApplyMappings(const std::vector<TileManager::Tile>& tiles, bool map);
+    void QueueReads(const std::vector<TileManager::Tile>& tiles);
+    void SubmitFinishedReads();
+    void PublishView(UINT32 texture);
+    void ReleaseView(Texture& t);
+
+private:
+    ID3D12Device* m_device = nullptr;
+    QueueScheduler* m_queues = nullptr;
+    CopyUploader* m_uploader = nullptr;
+    DescriptorPool* m_viewPool = nullptr;
+    DescriptorRing* m_descriptors = nullptr;
+    DeferredReleaseQueue* m_releases = nullptr;
+
+    ComPtr<ID3D12Heap> m_heap;          ///< physical tile pool
+    UINT32 m_tileBudget = 0;            ///< tiles read per frame
+    TileManager m_tiles;
+    TileManager::Plan m_plan;
+    std::vector<Texture> m_textures;    ///< by TileManager id
+    std::deque<CopyBatch> m_copies;
+    std::vector<UINT32> m_changed;
+
+    // Reader thread
+    std::thread m_reader;
+    mutable std::mutex m_readMutex;
+    std::condition_variable m_readCv;
+    std::deque<Read> m_reads;
+    std::vector<Read> m_finished;
+    UINT32 m_readsInFlight = 0;
+    bool m_stop = false;
+    UINT64 m_bytesRead = 0;
+};
@@ -0,0 +1,381 @@
+#include "TileManager.h"
+#include <algorithm>
+
+// -----------------------------------------------------------
+// Setup
+// -----------------------------------------------------------
+void TileManager::Reset(uint32_t poolTiles)
+{
+    m_textures.clear();
+    m_freeTextures.clear();
+    m_retiring.clear();
+
+    // Reverse order: low pool tiles are handed out first
+    m_freeTiles.clear();
+    for (uint32_t i = poolTiles; i-- > 0;)
+        m_freeTiles.push_back(i);
+
+    m_stats = Stats{};
+    m_stats.poolTiles = poolTiles;
+    m_stats.freeTiles = poolTiles;
+}
+
+// -----------------------------------------------------------
+// Textures
+// -----------------------------------------------------------
+uint32_t TileManager::AddTexture(const TextureLayout& layout)
+{
+    uint32_t id;
+    if (!m_freeTextures.empty())
+    {
+        id = m_freeTextures.back();
+        m_freeTextures.pop_back();
+    }
+    else
+    {
+        id = static_cast<uint32_t>(m_textures.size());
+        m_textures.emplace_back();
+    }
+
+    Texture& t = m_textures[id];
+    const uint32_t generation = t.generation + 1;
+    t = Texture{};
+    t.live = true;
+    t.generation = generation;
+    t.packedTiles = layout.packedTiles;
+
+    uint32_t tileCount = 0;
+    for (const TextureLayout::Mip& mip : layout.mips)
+    {
+        Level level;
+        level.tilesX = mip.tilesX;
+        level.tilesY = mip.tilesY;
+        level.firstTile = tileCount;
+        tileCount += mip.tilesX * mip.tilesY;
+        t.levels.push_back(level);
+    }
+    if (layout.packedTiles > 0)
+    {
+        Level level;
+        level.tilesX = layout.packedTiles;
+        level.tilesY = 1;
+        level.firstTile = tileCount;
+        tileCount += layout.packedTiles;
+        t.levels.push_back(level);
+    }
+
+    t.tiles.resize(tileCount);
+    t.residentLevel = static_cast<uint32_t>(t.levels.size());
+    return id;
+}
+
+void TileManager::RemoveTexture(uint32_t texture, uint64_t fenceValue)
+{
+    Texture& t = m_textures[texture];
+    if (!t.live) return;
+
+    for (uint32_t l = 0; l < t.levels.size(); ++l)
+    {
+        const Level& level = t.levels[l];
+        for (uint32_t i = 0; i < level.tilesX * level.tilesY; ++i)
+        {
+            TileSlot& slot = t.tiles[level.firstTile + i];
+            if (slot.physical == kInvalid) continue;
+
+            if (slot.state == TileState::Loading) --m_stats.loadingTiles;
+            else --m_stats.residentTiles;
+
+            // The resource goes away with the texture; nothing to unmap
+            Tile tile{ texture, l, i % level.tilesX, i / level.tilesX, slot.physical };
+            m_retiring.push_back({ fenceValue, tile, t.generation, false });
+            ++m_stats.retiringTiles;
+        }
+    }
+
+    t.live = false;
+    t.levels.clear();
+    t.tiles.clear();
+    m_freeTextures.push_back(texture);
+}
+
+void TileManager::Request(uint32_t texture, uint32_t mip, uint64_t fenceValue)
+{
+    Texture& t = m_textures[texture];
+    if (!t.live || t.levels.empty()) return;
+
+    const uint32_t last = static_cast<uint32_t>(t.levels.size() - 1);
+    for (uint32_t l = mip < last ? mip : last; l <= last; ++l)
+    {
+        Level& level = t.levels[l];
+        if (fenceValue > level.lastWanted) level.lastWanted = fenceValue;
+        level.wantedEver = true;
+    }
+}
+
+uint32_t TileManager::ResidentMip(uint32_t texture) const
+{
+    const Texture& t = m_textures[texture];
+    if (!t.live || t.residentLevel >= t.levels.size()) return kInvalid;
+    return t.residentLevel;
+}
+
+// -----------------------------------------------------------
+// Per frame
+// -----------------------------------------------------------
+bool TileManager::IsWanted(const Level& level, uint64_t fenceValue) const
+{
+    return level.wantedEver && level.lastWanted + m_evictDelay >= fenceValue;
+}
+
+uint32_t TileManager::FinestMappedLevel(const Texture& t) const
+{
+    for (uint32_t l = 0; l < t.levels.size(); ++l)
+        if (t.levels[l].mapped > 0) return l;
+    return kInvalid;
+}
+
+void TileManager::Update(uint64_t fenceValue, uint64_t completedFence, uint32_t tileBudget, Plan& out)
+{
+    out.map.clear();
+    out.unmap.clear();
+    out.changed.clear();
+
+    // 1. Tiles whose last sampling frame has completed go back to the pool
+    while (!m_retiring.empty() && m_retiring.front().fenceValue <= completedFence)
+    {
+        const Retiring r = m_retiring.front();
+        m_retiring.pop_front();
+
+        // Skip the unmap if the tile has been mapped again since
+        const Texture& t = m_textures[r.tile.texture];
+        if (r.unmap && t.live && t.generation == r.generation &&
+            t.tiles[t.levels[r.tile.level].firstTile + r.tile.y * t.levels[r.tile.level].tilesX + r.tile.x].physical == kInvalid)
+        {
+            out.unmap.push_back(r.tile);
+        }
+
+        m_freeTiles.push_back(r.tile.physical);
+        --m_stats.retiringTiles;
+    }
+
+    // 2. Levels nobody asked for in a while, finest first; the coarsest
+    //    level always stays
+    for (uint32_t id = 0; id < m_textures.size(); ++id)
+    {
+        Texture& t = m_textures[id];
+        if (!t.live) continue;
+
+        const uint32_t residentBefore = t.residentLevel;
+        for (;;)
+        {
+            const uint32_t l = FinestMappedLevel(t);
+            if (l == kInvalid || l + 1 == t.levels.size()) break;
+            const Level& level = t.levels[l];
+            if (level.loading > 0 || IsWanted(level, fenceValue)) break;
+            EvictLevel(id, l, fenceValue);
+        }
+        if (t.residentLevel != residentBefore)
+            out.changed.push_back(id);
+    }
+
+    // 3. Map wanted levels, coarsest first across all textures
+    struct Candidate
+    {
+        uint32_t texture;
+        uint32_t level;
+        uint32_t depth;         ///< 0 = coarsest level
+        uint64_t lastWanted;
+    };
+    std::vector<Candidate> candidates;
+    for (uint32_t id = 0; id < m_textures.size(); ++id)
+    {
+        const Texture& t = m_textures[id];
+        if (!t.live) continue;
+
+        const uint32_t last = static_cast<uint32_t>(t.levels.size() - 1);
+        for (uint32_t l = 0; l <= last; ++l)
+        {
+            const Level& level = t.levels[l];
+            const bool wanted = l == last || IsWanted(level, fenceValue);
+            if (wanted && level.mapped < level.tilesX * level.tilesY)
+                candidates.push_back({ id, l, last - l, level.lastWanted });
+        }
+    }
+    std::sort(candidates.begin(), candidates.end(), [](const Candidate& a, const Candidate& b)
+    {
+        if (a.depth != b.depth) return a.depth < b.depth;
+        return a.lastWanted > b.lastWanted;
+    });
+
+    bool evicted = false;
+    for (const Candidate& c : candidates)
+    {
+        Texture& t = m_textures[c.texture];
+        Level& level = t.levels[c.level];
+        const uint32_t count = level.tilesX * level.tilesY;
+
+        // Only on top of a fully mapped coarser level
+        if (c.level + 1 < t.levels.size())
+        {
+            const Level& coarser = t.levels[c.level + 1];
+            if (coarser.mapped < coarser.tilesX * coarser.tilesY) continue;
+        }
+
+        // The packed level is filled by one copy, so it is mapped as a whole
+        const bool packed = IsPackedLevel(c.texture, c.level);
+        const uint32_t needed = packed ? count - level.mapped : 1;
+        if (m_freeTiles.size() < needed)
+        {
+            // Evicted tiles come back once the GPU is past this frame; one victim per frame
+            if (!evicted)
+            {
+                const uint32_t victim = EvictForSpace(fenceValue, level.lastWanted);
+                evicted = victim != kInvalid;
+                if (evicted && std::find(out.changed.begin(), out.changed.end(), victim) == out.changed.end())
+                    out.changed.push_back(victim);
+            }
+            break;
+        }
+        if (!packed && tileBudget == 0) break;
+
+        for (uint32_t i = 0; i < count && (packed || tileBudget > 0); ++i)
+        {
+            TileSlot& slot = t.tiles[level.firstTile + i];
+            if (slot.physical != kInvalid) continue;
+            if (m_freeTiles.empty()) break;
+
+            slot.physical = m_freeTiles.back();
+            m_freeTiles.pop_back();
+            slot.state = TileState::Loading;
+            ++level.mapped;
+            ++level.loading;
+            ++m_stats.loadingTiles;
+            if (tileBudget > 0) --tileBudget;
+
+            out.map.push_back({ c.texture, c.level, i % level.tilesX, i / level.tilesX, slot.physical });
+        }
+    }
+
+    m_stats.freeTiles = static_cast<uint32_t>(m_freeTiles.size());
+}
+
+void TileManager::EvictLevel(uint32_t texture, uint32_t levelIndex, uint64_t fenceValue)
+{
+    Texture& t = m_textures[texture];
+    Level& level = t.levels[levelIndex];
+
+    for (uint32_t i = 0; i < level.tilesX * level.tilesY; ++i)
+    {
+        TileSlot& slot = t.tiles[level.firstTile + i];
+        if (slot.physical == kInvalid) continue;
+
+        Tile tile{ texture, levelIndex, i % level.tilesX, i / level.tilesX, slot.physical };
+        m_retiring.push_back({ fenceValue, tile, t.generation, true });
+        slot.physical = kInvalid;
+        slot.state = TileState::Unmapped;
+
+        --m_stats.residentTiles;
+        ++m_stats.retiringTiles;
+        ++m_stats.tilesEvicted;
+    }
+
+    level.mapped = 0;
+    level.resident = 0;
+
+    // Frames from this one on clamp to the next coarser level
+    if (t.residentLevel <= levelIndex)
+        t.residentLevel = levelIndex + 1;
+}
+
+uint32_t TileManager::EvictForSpace(uint64_t fenceValue, uint64_t requesterWanted)
+{
+    // Least recently wanted finest level that this frame does not need
+    uint32_t victim = kInvalid;
+    uint32_t victimLevel = 0;
+    uint64_t oldest = requesterWanted;
+
+    for (uint32_t id = 0; id < m_textures.size(); ++id)
+    {
+        const Texture& t = m_textures[id];
+        if (!t.live) continue;
+
+        const uint32_t l = FinestMappedLevel(t);
+        if (l == kInvalid || l + 1 == t.levels.size()) continue;
+        const Level& level = t.levels[l];
+        if (level.loading > 0 || level.lastWanted >= fenceValue) continue;
+
+        if (level.lastWanted < oldest)
+        {
+            oldest = level.lastWanted;
+            victim = id;
+            victimLevel = l;
+        }
+    }
+
+    if (victim == kInvalid) return kInvalid;
+    EvictLevel(victim, victimLevel, fenceValue);
+    return victim;
+}
+
+void TileManager::OnTilesLoaded(const std::vector<Tile>& tiles, std::vector<uint32_t>& changed)
+{
+    for (const Tile& tile : tiles)
+    {
+        Texture& t = m_textures[tile.texture];
+        if (!t.live) continue;
+
+        Level& level = t.levels[tile.level];
+        TileSlot& slot = t.tiles[level.firstTile + tile.y * level.tilesX + tile.x];
+        if (slot.state != TileState::Loading || slot.physical != tile.physical) continue;
+
+        slot.state = TileState::Resident;
+        --level.loading;
+        ++level.resident;
+        --m_stats.loadingTiles;
+        ++m_stats.residentTiles;
+        ++m_stats.tilesLoaded;
+
+        if (UpdateResidentLevel(tile.texture) &&
+            std::find(changed.begin(), changed.end(), tile.texture) == changed.end())
+        {
+            changed.push_back(tile.texture);
+        }
+    }
+}
+
+void TileManager::OnTilesFailed(const std::vector<Tile>& tiles)
+{
+    for (const Tile& tile : tiles)
+    {
+        Texture& t = m_textures[tile.texture];
+        if (!t.live) continue;
+
+        Level& level = t.levels[tile.level];
+        TileSlot& slot = t.tiles[level.firstTile + tile.y * level.tilesX + tile.x];
+        if (slot.state != TileState::Loading || slot.physical != tile.physical) continue;
+
+        slot.physical = kInvalid;
+        slot.state = TileState::Unmapped;
+        --level.mapped;
+        --level.loading;
+        --m_stats.loadingTiles;
+        ++m_stats.tilesFailed;
+
+        // Nothing sampled it, so it need not wait for a frame to complete
+        m_retiring.push_front({ 0, tile, t.generation, true });
+        ++m_stats.retiringTiles;
+    }
+}
+
+bool TileManager::UpdateResidentLevel(uint32_t texture)
+{
+    Texture& t = m_textures[texture];
+
+    uint32_t r = static_cast<uint32_t>(t.levels.size());
+    while (r > 0 && t.levels[r - 1].resident == t.levels[r - 1].tilesX * t.levels[r - 1].tilesY)
+        --r;
+
+    if (r == t.residentLevel) return false;
+    t.residentLevel = r;
+    return true;
+}
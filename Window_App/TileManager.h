@@ -0,0 +1,160 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+// -----------------------------------------------------------
+// TileManager
+//   Decides which tiles of streamed (reserved) textures are backed
+//   by the physical tile pool. Each texture is a chain of levels:
+//   its standard mips, finest first, followed by one level holding
+//   the packed mips (always loaded first, never evicted).
+//
+//   Usage feedback arrives through Request(): the finest mip a frame
+//   wants. Update() then, within a per-frame tile budget,
+//     - maps tiles of wanted levels, coarsest level first,
+//     - evicts the finest levels nobody asked for in evictDelay
+//       frames, or the least recently wanted ones when the pool runs
+//       out,
+//     - hands tiles back to the pool only once the frame that stopped
+//       sampling them (resident level lowered) has completed.
+//   A level becomes resident when all its tiles are loaded and every
+//   coarser level is resident; ResidentMip() is the clamp for views.
+//
+//   Fence values and tile indices only; no device needed, so the
+//   policy can be unit tested. Not thread-safe.
+// -----------------------------------------------------------
+class TileManager
+{
+public:
+    static constexpr uint32_t kInvalid = 0xFFFFFFFFu;
+    static constexpr uint64_t kTileBytes = 64 * 1024;
+
+    struct TextureLayout
+    {
+        struct Mip { uint32_t tilesX = 0, tilesY = 0; };
+        std::vector<Mip> mips;      ///< standard (non-packed) mips, finest first
+        uint32_t packedTiles = 0;   ///< tiles holding every packed mip (0 = none)
+    };
+
+    // One tile to map / unmap. For the packed level x is the tile index
+    // inside the packed region and y is 0.
+    struct Tile
+    {
+        uint32_t texture = kInvalid;
+        uint32_t level = 0;
+        uint32_t x = 0;
+        uint32_t y = 0;
+        uint32_t physical = kInvalid;   ///< pool tile index
+    };
+
+    struct Plan
+    {
+        std::vector<Tile> map;          ///< map, then fill from disk
+        std::vector<Tile> unmap;        ///< map to NULL; pool slot already released
+        std::vector<uint32_t> changed;  ///< textures whose ResidentMip() changed
+    };
+
+    struct Stats
+    {
+        uint32_t poolTiles = 0;
+        uint32_t freeTiles = 0;
+        uint32_t loadingTiles = 0;
+        uint32_t residentTiles = 0;
+        uint32_t retiringTiles = 0;     ///< evicted, waiting for the GPU
+        uint64_t tilesLoaded = 0;       ///< totals
+        uint64_t tilesEvicted = 0;
+        uint64_t tilesFailed = 0;
+    };
+
+    explicit TileManager(uint32_t poolTiles = 0) { Reset(poolTiles); }
+
+    void Reset(uint32_t poolTiles);
+
+    /// Levels wanted within this many frames are kept / loaded.
+    void SetEvictDelay(uint64_t frames) { m_evictDelay = frames; }
+
+    uint32_t AddTexture(const TextureLayout& layout);
+    /// Tiles return to the pool once `fenceValue` has completed; no unmaps are reported.
+    void RemoveTexture(uint32_t texture, uint64_t fenceValue);
+
+    /// Usage feedback: the frame at `fenceValue` samples mips >= mip.
+    void Request(uint32_t texture, uint32_t mip, uint64_t fenceValue);
+
+    /// Plans this frame's mapping changes; at most tileBudget tiles are mapped.
+    void Update(uint64_t fenceValue, uint64_t completedFence, uint32_t tileBudget, Plan& out);
+
+    /// The fill of previously mapped tiles has completed.
+    void OnTilesLoaded(const std::vector<Tile>& tiles, std::vector<uint32_t>& changed);
+
+    /// The fill of previously mapped tiles failed (read or copy). They were
+    /// never sampled, so the next Update() unmaps them and returns them to
+    /// the pool; a level still wanted is mapped and read again.
+    void OnTilesFailed(const std::vector<Tile>& tiles);
+
+    /// Finest fully resident mip (the packed level counts as the first packed
+    /// mip); kInvalid until the coarsest level is resident.
+    uint32_t ResidentMip(uint32_t texture) const;
+    uint32_t LevelWidthInTiles(uint32_t texture, uint32_t level) const { return m_textures[texture].levels[level].tilesX; }
+    uint32_t LevelCount(uint32_t texture) const { return static_cast<uint32_t>(m_textures[texture].levels.size()); }
+    bool IsPackedLevel(uint32_t texture, uint32_t level) const
+    {
+        return m_textures[texture].packedTiles > 0 && level + 1 == m_textures[texture].levels.size();
+    }
+
+    const Stats& GetStats() const { return m_stats; }
+
+private:
+    enum class TileState : uint8_t { Unmapped, Loading, Resident };
+
+    struct TileSlot
+    {
+        uint32_t physical = kInvalid;
+        TileState state = TileState::Unmapped;
+    };
+
+    struct Level
+    {
+        uint32_t tilesX = 0;
+        uint32_t tilesY = 0;
+        uint32_t firstTile = 0;     ///< into Texture::tiles
+        uint32_t mapped = 0;        ///< tiles Loading or Resident
+        uint32_t loading = 0;
+        uint32_t resident = 0;
+        uint64_t lastWanted = 0;    ///< fence of the last frame that wanted it
+        bool wantedEver = false;
+    };
+
+    struct Texture
+    {
+        bool live = false;
+        uint32_t generation = 0;    ///< bumped when the slot is reused
+        uint32_t packedTiles = 0;
+        std::vector<Level> levels;
+        std::vector<TileSlot> tiles;
+        uint32_t residentLevel = 0; ///< levels.size() = none
+    };
+
+    struct Retiring
+    {
+        uint64_t fenceValue;
+        Tile tile;
+        uint32_t generation;
+        bool unmap;
+    };
+
+    bool IsWanted(const Level& level, uint64_t fenceValue) const;
+    void EvictLevel(uint32_t texture, uint32_t level, uint64_t fenceValue);
+    uint32_t EvictForSpace(uint64_t fenceValue, uint64_t requesterWanted);    ///< returns the victim texture (kInvalid if none)
+    bool UpdateResidentLevel(uint32_t texture);
+    uint32_t FinestMappedLevel(const Texture& t) const;
+
+private:
+    std::vector<Texture> m_textures;
+    std::vector<uint32_t> m_freeTextures;
+    std::vector<uint32_t> m_freeTiles;      ///< pool
+    std::deque<Retiring> m_retiring;        ///< ordered by fence value (failed tiles at 0 in front)
+    uint64_t m_evictDelay = 60;
+    Stats m_stats;
+};
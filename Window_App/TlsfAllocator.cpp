@@ -0,0 +1,324 @@
+#include "TlsfAllocator.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace
+{
+    // Single-instruction bit scans; value must not be 0
+    uint32_t HighestBit(uint64_t value)
+    {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_ARM64))
+        unsigned long bit;
+        _BitScanReverse64(&bit, value);
+        return bit;
+#elif defined(_MSC_VER)
+        unsigned long bit;
+        if (_BitScanReverse(&bit, static_cast<unsigned long>(value >> 32)))
+            return bit + 32;
+        _BitScanReverse(&bit, static_cast<unsigned long>(value));
+        return bit;
+#else
+        return 63 - static_cast<uint32_t>(__builtin_clzll(value));
+#endif
+    }
+
+    uint32_t LowestBit(uint64_t value)
+    {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_ARM64))
+        unsigned long bit;
+        _BitScanForward64(&bit, value);
+        return bit;
+#elif defined(_MSC_VER)
+        unsigned long bit;
+        if (_BitScanForward(&bit, static_cast<unsigned long>(value)))
+            return bit;
+        _BitScanForward(&bit, static_cast<unsigned long>(value >> 32));
+        return bit + 32;
+#else
+        return static_cast<uint32_t>(__builtin_ctzll(value));
+#endif
+    }
+
+    uint64_t AlignUp(uint64_t value, uint64_t alignment)
+    {
+        return (value + alignment - 1) & ~(alignment - 1);
+    }
+}
+
+TlsfAllocator::TlsfAllocator(uint64_t capacity, uint64_t granularity)
+{
+    Reset(capacity, granularity);
+}
+
+void TlsfAllocator::Reset(uint64_t capacity, uint64_t granularity)
+{
+    m_granularity = granularity ? granularity : 1;
+    m_capacity = capacity & ~(m_granularity - 1);
+
+    m_blocks.clear();
+    m_unusedBlocks.clear();
+    m_firstLevelBitmap = 0;
+    for (uint32_t fl = 0; fl < kFirstLevelCount; ++fl)
+    {
+        m_secondLevelBitmap[fl] = 0;
+        for (uint32_t sl = 0; sl < kSecondLevelCount; ++sl)
+            m_freeHeads[fl][sl] = kInvalid;
+    }
+    m_usedBytes = 0;
+    m_allocationCount = 0;
+
+    if (m_capacity == 0) return;
+
+    const uint32_t block = NewBlock();
+    m_blocks[block].offset = 0;
+    m_blocks[block].size = m_capacity;
+    InsertFree(block);
+}
+
+uint64_t TlsfAllocator::RequiredCapacity(uint64_t size, uint64_t alignment, uint64_t granularity)
+{
+    if (size == 0) return 0;
+    if (granularity == 0) granularity = 1;
+    size = AlignUp(size, granularity);
+    if (alignment < granularity) alignment = granularity;
+
+    // Same padding and size-class rounding as Allocate / FindFreeBlock
+    uint64_t padded = size + (alignment > granularity ? alignment - granularity : 0);
+    const uint32_t fl = HighestBit(padded);
+    if (fl >= kSecondLevelBits)
+        padded = AlignUp(padded, 1ull << (fl - kSecondLevelBits));
+    return AlignUp(padded, granularity);
+}
+
+// -----------------------------------------------------------
+// Size classes
+// -----------------------------------------------------------
+void TlsfAllocator::Mapping(uint64_t size, uint32_t& fl, uint32_t& sl) const
+{
+    fl = HighestBit(size);
+    if (fl < kSecondLevelBits)
+        sl = static_cast<uint32_t>(size) & (kSecondLevelCount - 1);
+    else
+        sl = static_cast<uint32_t>(size >> (fl - kSecondLevelBits)) & (kSecondLevelCount - 1);
+}
+
+uint32_t TlsfAllocator::FindFreeBlock(uint64_t size) const
+{
+    // Round up to the next size class so that any block in the bin fits
+    const uint32_t fl0 = HighestBit(size);
+    if (fl0 >= kSecondLevelBits)
+        size += (1ull << (fl0 - kSecondLevelBits)) - 1;
+
+    uint32_t fl, sl;
+    Mapping(size, fl, sl);
+    if (fl >= kFirstLevelCount) return kInvalid;
+
+    uint32_t slMap = m_secondLevelBitmap[fl] & (~0u << sl);
+    if (!slMap)
+    {
+        const uint64_t flMap = fl + 1 < kFirstLevelCount ? m_firstLevelBitmap & (~0ull << (fl + 1)) : 0;
+        if (!flMap) return kInvalid;
+        fl = LowestBit(flMap);
+        slMap = m_secondLevelBitmap[fl];
+    }
+    sl = LowestBit(slMap);
+    return m_freeHeads[fl][sl];
+}
+
+void TlsfAllocator::InsertFree(uint32_t block)
+{
+    Block& b = m_blocks[block];
+    uint32_t fl, sl;
+    Mapping(b.size, fl, sl);
+
+    b.free = true;
+    b.prevFree = kInvalid;
+    b.nextFree = m_freeHeads[fl][sl];
+    if (b.nextFree != kInvalid)
+        m_blocks[b.nextFree].prevFree = block;
+    m_freeHeads[fl][sl] = block;
+
+    m_firstLevelBitmap |= 1ull << fl;
+    m_secondLevelBitmap[fl] |= 1u << sl;
+}
+
+void TlsfAllocator::RemoveFree(uint32_t block)
+{
+    Block& b = m_blocks[block];
+    uint32_t fl, sl;
+    Mapping(b.size, fl, sl);
+
+    if (b.prevFree != kInvalid) m_blocks[b.prevFree].nextFree = b.nextFree;
+    if (b.nextFree != kInvalid) m_blocks[b.nextFree].prevFree = b.prevFree;
+    if (m_freeHeads[fl][sl] == block)
+    {
+        m_freeHeads[fl][sl] = b.nextFree;
+        if (b.nextFree == kInvalid)
+        {
+            m_secondLevelBitmap[fl] &= ~(1u << sl);
+            if (!m_secondLevelBitmap[fl])
+                m_firstLevelBitmap &= ~(1ull << fl);
+        }
+    }
+
+    b.free = false;
+    b.prevFree = b.nextFree = kInvalid;
+}
+
+// -----------------------------------------------------------
+// Block bookkeeping
+// -----------------------------------------------------------
+uint32_t TlsfAllocator::NewBlock()
+{
+    uint32_t index;
+    if (!m_unusedBlocks.empty())
+    {
+        index = m_unusedBlocks.back();
+        m_unusedBlocks.pop_back();
+
+        // The generation outlives the slot so old handles stay stale
+        const uint32_t generation = m_blocks[index].generation;
+        m_blocks[index] = Block{};
+        m_blocks[index].generation = generation;
+    }
+    else
+    {
+        index = static_cast<uint32_t>(m_blocks.size());
+        m_blocks.emplace_back();
+    }
+    m_blocks[index].used = true;
+    return index;
+}
+
+void TlsfAllocator::ReleaseBlock(uint32_t block)
+{
+    m_blocks[block].used = false;
+    m_unusedBlocks.push_back(block);
+}
+
+uint32_t TlsfAllocator::Split(uint32_t block, uint64_t size)
+{
+    if (m_blocks[block].size <= size) return kInvalid;
+
+    const uint32_t rest = NewBlock();
+    Block& b = m_blocks[block];     // NewBlock may have reallocated
+    Block& r = m_blocks[rest];
+
+    r.offset = b.offset + size;
+    r.size = b.size - size;
+    r.prevPhysical = block;
+    r.nextPhysical = b.nextPhysical;
+    if (b.nextPhysical != kInvalid)
+        m_blocks[b.nextPhysical].prevPhysical = rest;
+
+    b.size = size;
+    b.nextPhysical = rest;
+    return rest;
+}
+
+uint32_t TlsfAllocator::Merge(uint32_t first, uint32_t second)
+{
+    Block& a = m_blocks[first];
+    const Block& b = m_blocks[second];
+
+    a.size += b.size;
+    a.nextPhysical = b.nextPhysical;
+    if (b.nextPhysical != kInvalid)
+        m_blocks[b.nextPhysical].prevPhysical = first;
+
+    ReleaseBlock(second);
+    return first;
+}
+
+// -----------------------------------------------------------
+// Allocate / Free
+// -----------------------------------------------------------
+TlsfAllocator::Allocation TlsfAllocator::Allocate(uint64_t size, uint64_t alignment)
+{
+    Allocation result;
+    if (size == 0) return result;
+
+    size = AlignUp(size, m_granularity);
+    if (alignment < m_granularity) alignment = m_granularity;
+
+    // Splitting takes up to two new blocks; each must fit in a handle
+    if (m_blocks.size() + 2 > kMaxBlocks + m_unusedBlocks.size()) return result;
+
+    // Over-ask by the worst-case padding so the block found always fits
+    const uint64_t padded = size + (alignment > m_granularity ? alignment - m_granularity : 0);
+    uint32_t block = FindFreeBlock(padded);
+    if (block == kInvalid) return result;
+    RemoveFree(block);
+
+    // Leading padding becomes its own free block
+    const uint64_t aligned = AlignUp(m_blocks[block].offset, alignment);
+    if (aligned != m_blocks[block].offset)
+    {
+        const uint32_t head = block;
+        block = Split(head, aligned - m_blocks[head].offset);
+        InsertFree(head);
+    }
+
+    // Trailing remainder goes back to the free lists
+    const uint32_t rest = Split(block, size);
+    if (rest != kInvalid)
+        InsertFree(rest);
+
+    m_usedBytes += m_blocks[block].size;
+    ++m_allocationCount;
+
+    Block& b = m_blocks[block];
+    b.generation = (b.generation + 1) & (0xFFFFFFFFu >> kBlockIndexBits);
+
+    result.offset = b.offset;
+    result.size = b.size;
+    result.block = block | (b.generation << kBlockIndexBits);
+    return result;
+}
+
+void TlsfAllocator::Free(uint32_t handle)
+{
+    uint32_t block = handle & kBlockIndexMask;
+    if (handle == kInvalid || block >= m_blocks.size()) return;
+
+    const Block& b = m_blocks[block];
+    if (!b.used || b.free || b.generation != handle >> kBlockIndexBits) return;
+
+    m_usedBytes -= m_blocks[block].size;
+    --m_allocationCount;
+
+    const uint32_t prev = m_blocks[block].prevPhysical;
+    if (prev != kInvalid && m_blocks[prev].free)
+    {
+        RemoveFree(prev);
+        block = Merge(prev, block);
+    }
+
+    const uint32_t next = m_blocks[block].nextPhysical;
+    if (next != kInvalid && m_blocks[next].free)
+    {
+        RemoveFree(next);
+        block = Merge(block, next);
+    }
+
+    InsertFree(block);
+}
+
+TlsfAllocator::Stats TlsfAllocator::GetStats() const
+{
+    Stats s;
+    s.capacity = m_capacity;
+    s.usedBytes = m_usedBytes;
+    s.freeBytes = m_capacity - m_usedBytes;
+    s.allocationCount = m_allocationCount;
+
+    for (const Block& b : m_blocks)
+    {
+        if (!b.used || !b.free) continue;
+        ++s.freeBlockCount;
+        if (b.size > s.largestFreeBlock) s.largestFreeBlock = b.size;
+    }
+    return s;
+}
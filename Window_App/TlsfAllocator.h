@@ -0,0 +1,115 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+// -----------------------------------------------------------
+// TlsfAllocator
+//   Two-level segregated fit allocator over an abstract range of
+//   `capacity` bytes. Free blocks are binned by size class (first
+//   level = power of two, second level = 16 linear subdivisions);
+//   two bitmaps find a fitting non-empty bin in O(1), and freed
+//   blocks merge with their physical neighbours in O(1).
+//
+//   Offsets only; the allocator never touches memory, so it backs
+//   both placed-resource heaps and buffer suballocation, and can be
+//   tested without a device. Not thread-safe.
+// -----------------------------------------------------------
+class TlsfAllocator
+{
+public:
+    static constexpr uint32_t kInvalid = 0xFFFFFFFFu;
+
+    struct Allocation
+    {
+        uint64_t offset = 0;
+        uint64_t size = 0;          ///< bytes reserved (>= requested)
+        uint32_t block = kInvalid;  ///< handle for Free() (block index + generation), kInvalid = failed
+
+        explicit operator bool() const { return block != kInvalid; }
+    };
+
+    struct Stats
+    {
+        uint64_t capacity = 0;
+        uint64_t usedBytes = 0;
+        uint64_t freeBytes = 0;
+        uint64_t largestFreeBlock = 0;
+        uint32_t allocationCount = 0;
+        uint32_t freeBlockCount = 0;
+
+        /// 0 = all free space is one block, approaching 1 = free space is scattered
+        double Fragmentation() const
+        {
+            return freeBytes ? 1.0 - static_cast<double>(largestFreeBlock) / freeBytes : 0.0;
+        }
+        double Utilization() const { return capacity ? static_cast<double>(usedBytes) / capacity : 0.0; }
+    };
+
+    /// granularity: every offset and size is a multiple of it (power of two).
+    explicit TlsfAllocator(uint64_t capacity = 0, uint64_t granularity = 256);
+
+    void Reset(uint64_t capacity, uint64_t granularity = 256);
+
+    /// Smallest capacity for which Allocate(size, alignment) succeeds on an
+    /// empty allocator (size-class rounding and alignment padding included).
+    static uint64_t RequiredCapacity(uint64_t size, uint64_t alignment, uint64_t granularity = 256);
+
+    /// alignment must be a power of two.
+    Allocation Allocate(uint64_t size, uint64_t alignment = 1);
+
+    /// Ignores handles that are invalid, already freed, or whose block
+    /// has since been handed out again.
+    void Free(uint32_t handle);
+
+    Stats GetStats() const;
+    uint64_t Capacity() const { return m_capacity; }
+    bool Empty() const { return m_allocationCount == 0; }
+
+private:
+    static constexpr uint32_t kSecondLevelBits = 4;
+    static constexpr uint32_t kSecondLevelCount = 1u << kSecondLevelBits;
+    static constexpr uint32_t kFirstLevelCount = 64;
+
+    // Handles carry the block's generation in the top bits so that a
+    // stale handle no longer matches once its block is reused
+    static constexpr uint32_t kBlockIndexBits = 24;
+    static constexpr uint32_t kBlockIndexMask = (1u << kBlockIndexBits) - 1;
+    static constexpr uint32_t kMaxBlocks = kBlockIndexMask;    ///< keeps every handle != kInvalid
+
+    struct Block
+    {
+        uint64_t offset = 0;
+        uint64_t size = 0;
+        uint32_t prevPhysical = kInvalid;
+        uint32_t nextPhysical = kInvalid;
+        uint32_t prevFree = kInvalid;
+        uint32_t nextFree = kInvalid;
+        bool free = false;
+        bool used = false;              ///< slot in m_blocks is alive
+        uint32_t generation = 0;        ///< bumped each time the block is allocated
+    };
+
+    void Mapping(uint64_t size, uint32_t& fl, uint32_t& sl) const;
+    uint32_t FindFreeBlock(uint64_t size) const;
+    void InsertFree(uint32_t block);
+    void RemoveFree(uint32_t block);
+    uint32_t NewBlock();
+    void ReleaseBlock(uint32_t block);
+    uint32_t Split(uint32_t block, uint64_t size);     ///< returns the remainder (kInvalid if none)
+    uint32_t Merge(uint32_t first, uint32_t second);   ///< both free, physically adjacent
+
+private:
+    uint64_t m_capacity = 0;
+    uint64_t m_granularity = 256;
+
+    std::vector<Block> m_blocks;
+    std::vector<uint32_t> m_unusedBlocks;
+
+    uint64_t m_firstLevelBitmap = 0;
+    uint32_t m_secondLevelBitmap[kFirstLevelCount]{};
+    uint32_t m_freeHeads[kFirstLevelCount][kSecondLevelCount];
+
+    uint64_t m_usedBytes = 0;
+    uint32_t m_allocationCount = 0;
+};
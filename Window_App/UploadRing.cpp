@@ -0,0 +1,63 @@
+#include "UploadRing.h"
+#include <cstring>
+#include "d3dx12.h"
+
+UploadRing::~UploadRing()
+{
+    Shutdown();
+}
+
+bool UploadRing::Initialize(ID3D12Device* device, UINT64 capacity, const wchar_t* name)
+{
+    // Keep the capacity a multiple of the largest alignment handed out
+    const UINT64 granularity = D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT;
+    capacity = (capacity + granularity - 1) & ~(granularity - 1);
+
+    CD3DX12_HEAP_PROPERTIES heap(D3D12_HEAP_TYPE_UPLOAD);
+    CD3DX12_RESOURCE_DESC desc = CD3DX12_RESOURCE_DESC::Buffer(capacity);
+    if (FAILED(device->CreateCommittedResource(&heap, D3D12_HEAP_FLAG_NONE, &desc,
+        D3D12_RESOURCE_STATE_GENERIC_READ, nullptr, IID_PPV_ARGS(&m_buffer))))
+        return false;
+    m_buffer->SetName(name);
+
+    // Upload heaps may stay mapped for their whole lifetime
+    CD3DX12_RANGE noRead(0, 0);
+    if (FAILED(m_buffer->Map(0, &noRead, reinterpret_cast<void**>(&m_cpu))))
+        return false;
+
+    m_gpu = m_buffer->GetGPUVirtualAddress();
+    m_ring.Reset(capacity);
+    return true;
+}
+
+void UploadRing::Shutdown()
+{
+    if (m_buffer && m_cpu)
+        m_buffer->Unmap(0, nullptr);
+    m_cpu = nullptr;
+    m_gpu = 0;
+    m_buffer.Reset();
+    m_ring.Reset(0);
+}
+
+UploadRing::Allocation UploadRing::Allocate(UINT64 size, UINT64 alignment)
+{
+    Allocation a;
+    const UINT64 offset = m_ring.Allocate(size, alignment);
+    if (offset == RingAllocator::kInvalidOffset)
+        return a;
+
+    a.resource = m_buffer.Get();
+    a.offset = offset;
+    a.cpu = m_cpu + offset;
+    a.gpu = m_gpu + offset;
+    return a;
+}
+
+UploadRing::Allocation UploadRing::Push(const void* data, UINT64 size, UINT64 alignment)
+{
+    Allocation a = Allocate(size, alignment);
+    if (a)
+        memcpy(a.cpu, data, static_cast<size_t>(size));
+    return a;
+}
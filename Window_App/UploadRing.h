@@ -0,0 +1,57 @@
+#pragma once
+
+#include <windows.h>
+#include <wrl.h>
+#include <d3d12.h>
+
+#include "RingAllocator.h"
+
+using Microsoft::WRL::ComPtr;
+
+// -----------------------------------------------------------
+// UploadRing
+//   One persistently mapped UPLOAD buffer shared by all frames in
+//   flight. Constants, dynamic vertices and staging data are
+//   suballocated at bump-pointer cost; each frame's allocations are
+//   sealed with its fence value and reused once the GPU is past it.
+//   Render thread only.
+// -----------------------------------------------------------
+class UploadRing
+{
+public:
+    struct Allocation
+    {
+        ID3D12Resource* resource = nullptr;     ///< nullptr = ring full
+        UINT64 offset = 0;
+        UINT8* cpu = nullptr;
+        D3D12_GPU_VIRTUAL_ADDRESS gpu = 0;
+
+        explicit operator bool() const { return resource != nullptr; }
+    };
+
+    UploadRing() = default;
+    ~UploadRing();
+
+    UploadRing(const UploadRing&) = delete;
+    UploadRing& operator=(const UploadRing&) = delete;
+
+    bool Initialize(ID3D12Device* device, UINT64 capacity, const wchar_t* name = L"Upload Ring");
+    void Shutdown();
+
+    /// Default alignment fits constant buffers (256 bytes).
+    Allocation Allocate(UINT64 size, UINT64 alignment = D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT);
+
+    /// Copies data into a fresh allocation.
+    Allocation Push(const void* data, UINT64 size, UINT64 alignment = D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT);
+
+    void Seal(UINT64 fenceValue) { m_ring.Seal(fenceValue); }
+    void Reclaim(UINT64 completedFence) { m_ring.Reclaim(completedFence); }
+
+    const RingAllocator& Allocator() const { return m_ring; }
+
+private:
+    ComPtr<ID3D12Resource> m_buffer;
+    UINT8* m_cpu = nullptr;
+    D3D12_GPU_VIRTUAL_ADDRESS m_gpu = 0;
+    RingAllocator m_ring;
+};
@@ -7,14 +7,29 @@ LRESULT CALLBACK WindowProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam)
 {
     switch (msg)
     {
+    case WM_CLOSE:
+        // Stop presenting before the window goes away
+        if (g_app) g_app->StopRenderThread();
+        break;
+
     case WM_DESTROY:
         PostQuitMessage(0);
         return 0;
 
     case WM_SIZE:
         // EBhETCYύXɉȂ炱
+        if (g_app && wParam != SIZE_MINIMIZED)
+            g_app->OnResize(LOWORD(lParam), HIWORD(lParam));
         return 0;
 
+    case WM_KEYDOWN:
+    case WM_KEYUP:
+    case WM_MOUSEMOVE:
+    case WM_LBUTTONDOWN:
+    case WM_LBUTTONUP:
+        if (g_app) g_app->OnInput();
+        break;
+
     case WM_PAINT:
     {
         PAINTSTRUCT ps;
@@ -59,7 +74,29 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE, LPSTR, int nCmdShow)
     UpdateWindow(hwnd);
 
     // DX12 
-    g_app = new DX12App(hwnd, 1280, 720);
+    DX12AppSettings settings;
+    settings.frameCount = 3; // frames in flight (2-4)
+    settings.frameLatencyWaitable = true;
+    settings.maxFrameLatency = 1; // latency budget (1-3)
+    settings.recordThreads = 0;   // record on every core
+    settings.staticBundles = true;
+    settings.enhancedBarriers = true; // falls back to legacy barriers if unsupported
+    settings.renderPasses = true;
+    settings.allowTearing = true; // VRR: no vsync
+    settings.targetFps = 240;     // paced on the CPU
+    settings.damageTracking = true; // redraw only what changed
+    settings.idleMode = true;       // no frames while nothing changes / occluded
+    settings.bindless = true;       // one resource table, handles in root constants
+    settings.residency = true;      // stay under the video memory budget
+    settings.streamingPoolBytes = 256ull << 20; // tile pool for streamed textures
+
+    // The first WM_SIZE arrives before g_app exists; start from the real client area
+    RECT client{};
+    GetClientRect(hwnd, &client);
+    const UINT width = client.right > client.left ? static_cast<UINT>(client.right - client.left) : 1;
+    const UINT height = client.bottom > client.top ? static_cast<UINT>(client.bottom - client.top) : 1;
+
+    g_app = new DX12App(hwnd, width, height, settings);
     if (!g_app->Initialize())
     {
         MessageBoxA(hwnd, "DirectX12 initialization failed.", "Error", MB_OK | MB_ICONERROR);
@@ -68,21 +105,20 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE, LPSTR, int nCmdShow)
         return -1;
     }
 
-    // C[v
+    // `̓_[Xbhōs
+    if (!g_app->StartRenderThread())
+    {
+        delete g_app;
+        g_app = nullptr;
+        return -1;
+    }
+
+    // C[v (UI thread only pumps messages)
     MSG msg{};
-    while (true)
+    while (GetMessage(&msg, nullptr, 0, 0) > 0)
     {
-        if (PeekMessage(&msg, nullptr, 0, 0, PM_REMOVE))
-        {
-            if (msg.message == WM_QUIT) break;
-            TranslateMessage(&msg);
-            DispatchMessage(&msg);
-        }
-        else
-        {
-            // `
-            g_app->Render();
-        }
+        TranslateMessage(&msg);
+        DispatchMessage(&msg);
     }
 
     delete g_app;